@@ -161,6 +161,12 @@ public:
         and32(imm, dest);
     }
 
+    // The result is undefined if src is zero.
+    void countTrailingZeros32(RegisterID src, RegisterID dest)
+    {
+        m_assembler.bsfl_rr(src, dest);
+    }
+
     void lshift32(RegisterID shift_amount, RegisterID dest)
     {
         ASSERT(shift_amount != dest);
@@ -878,12 +884,54 @@ public:
         m_assembler.por_rr(src, dst);
     }
 
+    void andPacked(XMMRegisterID src, XMMRegisterID dst)
+    {
+        ASSERT(isSSE2Present());
+        m_assembler.pand_rr(src, dst);
+    }
+
     void moveInt32ToPacked(RegisterID src, XMMRegisterID dst)
     {
         ASSERT(isSSE2Present());
         m_assembler.movd_rr(src, dst);
     }
 
+    // Fills all four 32-bit lanes of dst with the value of src.
+    void splatInt32ToPacked(RegisterID src, XMMRegisterID dst)
+    {
+        ASSERT(isSSE2Present());
+        m_assembler.movd_rr(src, dst);
+        m_assembler.pshufd_irr(0, dst, dst);
+    }
+
+    // Unaligned load of 16 bytes.
+    void loadPacked(BaseIndex address, XMMRegisterID dst)
+    {
+        ASSERT(isSSE2Present());
+        m_assembler.movdqu_mr(address.offset, address.base, address.index, address.scale, dst);
+    }
+
+    // Sets each 8 or 16-bit lane of dst to all ones if it is equal to the
+    // corresponding lane of src, and to zero if not.
+    void compareEqualPacked8(XMMRegisterID src, XMMRegisterID dst)
+    {
+        ASSERT(isSSE2Present());
+        m_assembler.pcmpeqb_rr(src, dst);
+    }
+
+    void compareEqualPacked16(XMMRegisterID src, XMMRegisterID dst)
+    {
+        ASSERT(isSSE2Present());
+        m_assembler.pcmpeqw_rr(src, dst);
+    }
+
+    // Gathers the top bit of each byte of src into the low 16 bits of dst.
+    void movePackedSignBits8ToInt32(XMMRegisterID src, RegisterID dst)
+    {
+        ASSERT(isSSE2Present());
+        m_assembler.pmovmskb_rr(src, dst);
+    }
+
     void movePackedToInt32(XMMRegisterID src, RegisterID dst)
     {
         ASSERT(isSSE2Present());
@@ -181,6 +181,10 @@ private:
         OP2_ANDNPD_VpdWpd   = 0x55,
         OP2_XORPD_VpdWpd    = 0x57,
         OP2_MOVD_VdEd       = 0x6E,
+        OP2_MOVDQU_VdqWdq   = 0x6F,
+        OP2_PSHUFD_VdqWdqIb = 0x70,
+        OP2_PCMPEQB_VdqWdq  = 0x74,
+        OP2_PCMPEQW_VdqWdq  = 0x75,
         OP2_MOVD_EdVd       = 0x7E,
         OP2_JCC_rel32       = 0x80,
         OP_SETCC            = 0x90,
@@ -189,9 +193,12 @@ private:
         OP2_MOVSX_GvEb      = 0xBE,
         OP2_MOVZX_GvEw      = 0xB7,
         OP2_MOVSX_GvEw      = 0xBF,
+        OP2_BSF_GvEv        = 0xBC,
         OP2_PEXTRW_GdUdIb   = 0xC5,
         OP2_PSLLQ_UdqIb     = 0x73,
         OP2_PSRLQ_UdqIb     = 0x73,
+        OP2_PMOVMSKB_GdUdq  = 0xD7,
+        OP2_PAND_VdqWdq     = 0xDB,
         OP2_POR_VdqWdq      = 0XEB,
     } TwoByteOpcodeID;
 
@@ -699,6 +706,11 @@ public:
     }
 #endif
 
+    void bsfl_rr(RegisterID src, RegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_BSF_GvEv, dst, src);
+    }
+
     void imull_rr(RegisterID src, RegisterID dst)
     {
         m_formatter.twoByteOp(OP2_IMUL_GvEv, dst, src);
@@ -1509,6 +1521,12 @@ public:
     }
 #endif
 
+    void movdqu_mr(int offset, RegisterID base, RegisterID index, int scale, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_F3);
+        m_formatter.twoByteOp(OP2_MOVDQU_VdqWdq, (RegisterID)dst, base, index, scale, offset);
+    }
+
     void movsd_rr(XMMRegisterID src, XMMRegisterID dst)
     {
         m_formatter.prefix(PRE_SSE_F2);
@@ -1576,6 +1594,24 @@ public:
         m_formatter.twoByteOp(OP2_MULSD_VsdWsd, (RegisterID)dst, base, offset);
     }
 
+    void pand_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PAND_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pcmpeqb_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PCMPEQB_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pcmpeqw_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PCMPEQW_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
     void pextrw_irr(int whichWord, XMMRegisterID src, RegisterID dst)
     {
         m_formatter.prefix(PRE_SSE_66);
@@ -1583,6 +1619,19 @@ public:
         m_formatter.immediate8(whichWord);
     }
 
+    void pmovmskb_rr(XMMRegisterID src, RegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PMOVMSKB_GdUdq, dst, (RegisterID)src);
+    }
+
+    void pshufd_irr(int order, XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PSHUFD_VdqWdqIb, (RegisterID)dst, (RegisterID)src);
+        m_formatter.immediate8(order);
+    }
+
     void psllq_i8r(int imm, XMMRegisterID dst)
     {
         m_formatter.prefix(PRE_SSE_66);
@@ -1782,9 +1831,9 @@ public:
         return b.m_offset - a.m_offset;
     }
     
-    PassRefPtr<ExecutableMemoryHandle> executableCopy(JSGlobalData& globalData, void* ownerUID)
+    PassRefPtr<ExecutableMemoryHandle> executableCopy(JSGlobalData& globalData, void* ownerUID, JITCompilationEffort effort = JITCompilationMustSucceed)
     {
-        return m_formatter.executableCopy(globalData, ownerUID);
+        return m_formatter.executableCopy(globalData, ownerUID, effort);
     }
 
     unsigned debugOffset() { return m_formatter.debugOffset(); }
@@ -2130,9 +2179,9 @@ private:
         bool isAligned(int alignment) const { return m_buffer.isAligned(alignment); }
         void* data() const { return m_buffer.data(); }
 
-        PassRefPtr<ExecutableMemoryHandle> executableCopy(JSGlobalData& globalData, void* ownerUID)
+        PassRefPtr<ExecutableMemoryHandle> executableCopy(JSGlobalData& globalData, void* ownerUID, JITCompilationEffort effort)
         {
-            return m_buffer.executableCopy(globalData, ownerUID);
+            return m_buffer.executableCopy(globalData, ownerUID, effort);
         }
 
         unsigned debugOffset() { return m_buffer.debugOffset(); }
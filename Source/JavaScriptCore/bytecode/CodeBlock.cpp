@@ -2205,6 +2205,27 @@ void FunctionCodeBlock::jettison()
     ASSERT(this == replacement());
     static_cast<FunctionExecutable*>(ownerExecutable())->jettisonOptimizedCodeFor(*globalData(), m_isConstructor ? CodeForConstruct : CodeForCall);
 }
+
+void ProgramCodeBlock::installOptimizedReplacement(PassOwnPtr<CodeBlock> codeBlock)
+{
+    ASSERT(getJITType() == JITCode::BaselineJIT);
+    ASSERT(this == replacement());
+    static_cast<ProgramExecutable*>(ownerExecutable())->installOptimizedCode(codeBlock);
+}
+
+void EvalCodeBlock::installOptimizedReplacement(PassOwnPtr<CodeBlock> codeBlock)
+{
+    ASSERT(getJITType() == JITCode::BaselineJIT);
+    ASSERT(this == replacement());
+    static_cast<EvalExecutable*>(ownerExecutable())->installOptimizedCode(codeBlock);
+}
+
+void FunctionCodeBlock::installOptimizedReplacement(PassOwnPtr<CodeBlock> codeBlock)
+{
+    ASSERT(getJITType() == JITCode::BaselineJIT);
+    ASSERT(this == replacement());
+    static_cast<FunctionExecutable*>(ownerExecutable())->installOptimizedCodeFor(codeBlock, m_isConstructor ? CodeForConstruct : CodeForCall);
+}
 #endif
 
 #if ENABLE(VALUE_PROFILER)
@@ -377,6 +377,9 @@ namespace JSC {
         virtual JSObject* compileOptimized(ExecState*, ScopeChainNode*) = 0;
         virtual void jettison() = 0;
         virtual CodeBlock* replacement() = 0;
+        // Makes a code block that was compiled in the background, and already has
+        // its JIT code, the replacement of this one.
+        virtual void installOptimizedReplacement(PassOwnPtr<CodeBlock>) = 0;
 
         enum CompileWithDFGState {
             CompileWithDFGFalse,
@@ -1235,6 +1238,7 @@ namespace JSC {
         virtual JSObject* compileOptimized(ExecState*, ScopeChainNode*);
         virtual void jettison();
         virtual CodeBlock* replacement();
+        virtual void installOptimizedReplacement(PassOwnPtr<CodeBlock>);
         virtual bool canCompileWithDFGInternal();
 #endif
     };
@@ -1269,6 +1273,7 @@ namespace JSC {
         virtual JSObject* compileOptimized(ExecState*, ScopeChainNode*);
         virtual void jettison();
         virtual CodeBlock* replacement();
+        virtual void installOptimizedReplacement(PassOwnPtr<CodeBlock>);
         virtual bool canCompileWithDFGInternal();
 #endif
 
@@ -1306,6 +1311,7 @@ namespace JSC {
         virtual JSObject* compileOptimized(ExecState*, ScopeChainNode*);
         virtual void jettison();
         virtual CodeBlock* replacement();
+        virtual void installOptimizedReplacement(PassOwnPtr<CodeBlock>);
         virtual bool canCompileWithDFGInternal();
 #endif
     };
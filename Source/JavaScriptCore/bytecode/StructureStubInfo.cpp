@@ -71,6 +71,7 @@ bool StructureStubInfo::visitWeakReferences()
 {
     switch (accessType) {
     case access_get_by_id_self:
+    case access_get_array_length:
         if (!Heap::isMarked(u.getByIdSelf.baseObjectStructure.get()))
             return false;
         break;
@@ -118,6 +118,15 @@ namespace JSC {
             u.getByIdChain.chain.set(globalData, owner, chain);
         }
 
+        void initGetArrayLength(JSGlobalData& globalData, JSCell* owner, Structure* arrayStructure)
+        {
+            accessType = access_get_array_length;
+
+            // Only kept so that a list built from this stub has a structure to
+            // weakly reference; the stub itself checks the ClassInfo.
+            u.getByIdSelf.baseObjectStructure.set(globalData, owner, arrayStructure);
+        }
+
         void initGetByIdSelfList(PolymorphicAccessStructureList* structureList, int listSize)
         {
             accessType = access_get_by_id_self_list;
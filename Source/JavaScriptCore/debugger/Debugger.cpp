@@ -22,6 +22,7 @@
 #include "config.h"
 #include "Debugger.h"
 
+#include "DFGWorklist.h"
 #include "Error.h"
 #include "Interpreter.h"
 #include "JSFunction.h"
@@ -117,6 +118,11 @@ void Debugger::recompileAllJSFunctions(JSGlobalData* globalData)
     if (globalData->dynamicGlobalObject)
         return;
 
+#if ENABLE(DFG_JIT)
+    if (globalData->dfgWorklist)
+        globalData->dfgWorklist->cancelAllPlans();
+#endif
+
     Recompiler recompiler(this);
     globalData->heap.objectSpace().forEachCell(recompiler);
 }
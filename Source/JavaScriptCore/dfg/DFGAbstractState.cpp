@@ -641,12 +641,12 @@ bool AbstractState::execute(NodeIndex nodeIndex)
             
     case NewArray:
     case NewArrayBuffer:
-        forNode(nodeIndex).set(m_codeBlock->globalObject()->arrayStructure());
+        forNode(nodeIndex).set(m_graph.globalObjectStructuresFor(m_codeBlock->globalObject()).arrayStructure);
         m_haveStructures = true;
         break;
             
     case NewRegexp:
-        forNode(nodeIndex).set(m_codeBlock->globalObject()->regExpStructure());
+        forNode(nodeIndex).set(m_graph.globalObjectStructuresFor(m_codeBlock->globalObject()).regExpStructure);
         m_haveStructures = true;
         break;
             
@@ -693,7 +693,7 @@ bool AbstractState::execute(NodeIndex nodeIndex)
     }
             
     case NewObject:
-        forNode(nodeIndex).set(m_codeBlock->globalObject()->emptyObjectStructure());
+        forNode(nodeIndex).set(m_graph.globalObjectStructuresFor(m_codeBlock->globalObject()).emptyObjectStructure);
         m_haveStructures = true;
         break;
             
@@ -69,6 +69,8 @@
 #define DFG_ENABLE_OSR_ENTRY ENABLE(DFG_JIT)
 // Generate stats on how successful we were in making use of the DFG jit, and remaining on the hot path.
 #define DFG_ENABLE_SUCCESS_STATS 0
+// Log the number of shapes seen by every get_by_id site whose inline cache becomes a list.
+#define DFG_ENABLE_POLYMORPHIC_ACCESS_STATS 0
 // Used to enable conditionally supported opcodes that currently result in performance regressions.
 #define DFG_ENABLE_RESTRICTIONS 1
 // Enable verification that the DFG is able to insert code for control flow edges.
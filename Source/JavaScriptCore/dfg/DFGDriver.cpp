@@ -28,17 +28,13 @@
 
 #if ENABLE(DFG_JIT)
 
-#include "DFGArithNodeFlagsInferencePhase.h"
-#include "DFGByteCodeParser.h"
-#include "DFGCFAPhase.h"
-#include "DFGCSEPhase.h"
-#include "DFGJITCompiler.h"
-#include "DFGPredictionPropagationPhase.h"
-#include "DFGVirtualRegisterAllocationPhase.h"
+#include "CodeBlock.h"
+#include "DFGPlan.h"
+#include "DFGWorklist.h"
+#include "JSGlobalData.h"
 
 namespace JSC { namespace DFG {
 
-enum CompileMode { CompileFunction, CompileOther };
 inline bool compile(CompileMode compileMode, JSGlobalData& globalData, CodeBlock* codeBlock, JITCode& jitCode, MacroAssemblerCodePtr* jitCodeWithArityCheck)
 {
     SamplingRegion samplingRegion("DFG Compilation (Driver)");
@@ -47,34 +43,21 @@ inline bool compile(CompileMode compileMode, JSGlobalData& globalData, CodeBlock
     ASSERT(codeBlock->alternative());
     ASSERT(codeBlock->alternative()->getJITType() == JITCode::BaselineJIT);
 
-#if DFG_ENABLE(DEBUG_VERBOSE)
-    dataLog("DFG compiling code block %p(%p), number of instructions = %u.\n", codeBlock, codeBlock->alternative(), codeBlock->instructionCount());
-#endif
-    
-    Graph dfg(globalData, codeBlock);
-    if (!parse(dfg))
+    Plan plan(compileMode, globalData, codeBlock);
+    if (!plan.parse())
         return false;
     
-    if (compileMode == CompileFunction)
-        dfg.predictArgumentTypes();
+    plan.generate();
 
-    performArithNodeFlagsInference(dfg);
-    performPredictionPropagation(dfg);
-    performCSE(dfg);
-    performVirtualRegisterAllocation(dfg);
-    performCFA(dfg);
-    
-    JITCompiler dataFlowJIT(dfg);
-    if (compileMode == CompileFunction) {
+    MacroAssemblerCodePtr ignoredJITCodeWithArityCheck;
+    if (compileMode == CompileFunction)
         ASSERT(jitCodeWithArityCheck);
-        
-        dataFlowJIT.compileFunction(jitCode, *jitCodeWithArityCheck);
-    } else {
+    else {
         ASSERT(compileMode == CompileOther);
         ASSERT(!jitCodeWithArityCheck);
-        
-        dataFlowJIT.compile(jitCode);
+        jitCodeWithArityCheck = &ignoredJITCodeWithArityCheck;
     }
+    plan.link(jitCode, *jitCodeWithArityCheck);
     
     return true;
 }
@@ -89,6 +72,43 @@ bool tryCompileFunction(JSGlobalData& globalData, CodeBlock* codeBlock, JITCode&
     return compile(CompileFunction, globalData, codeBlock, jitCode, &jitCodeWithArityCheck);
 }
 
+bool shouldCompileInBackground(JSGlobalData& globalData)
+{
+    return !!globalData.dfgWorklist;
+}
+
+inline PassOwnPtr<CodeBlock> compileInBackground(CompileMode compileMode, JSGlobalData& globalData, PassOwnPtr<CodeBlock> passedCodeBlock)
+{
+    SamplingRegion samplingRegion("DFG Compilation (Driver)");
+
+    OwnPtr<CodeBlock> codeBlock = passedCodeBlock;
+    ASSERT(codeBlock->alternative());
+    ASSERT(codeBlock->alternative()->getJITType() == JITCode::BaselineJIT);
+    ASSERT(globalData.dfgWorklist);
+
+    OwnPtr<Plan> plan = adoptPtr(new Plan(compileMode, globalData, codeBlock.get()));
+    bool parsed = plan->parse();
+
+    // From here on the plan only reads the profiles it copied into the graph,
+    // so the baseline code block can go back to its executable.
+    OwnPtr<CodeBlock> alternative = codeBlock->releaseAlternative();
+    if (parsed) {
+        plan->adoptCodeBlock(codeBlock.release());
+        globalData.dfgWorklist->enqueue(plan.release());
+    }
+    return alternative.release();
+}
+
+PassOwnPtr<CodeBlock> tryCompileInBackground(JSGlobalData& globalData, PassOwnPtr<CodeBlock> codeBlock)
+{
+    return compileInBackground(CompileOther, globalData, codeBlock);
+}
+
+PassOwnPtr<CodeBlock> tryCompileFunctionInBackground(JSGlobalData& globalData, PassOwnPtr<CodeBlock> codeBlock)
+{
+    return compileInBackground(CompileFunction, globalData, codeBlock);
+}
+
 } } // namespace JSC::DFG
 
 #endif // ENABLE(DFG_JIT)
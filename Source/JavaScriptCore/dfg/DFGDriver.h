@@ -26,6 +26,7 @@
 #ifndef DFGDriver_h
 #define DFGDriver_h
 
+#include <wtf/PassOwnPtr.h>
 #include <wtf/Platform.h>
 
 namespace JSC {
@@ -37,12 +38,25 @@ class MacroAssemblerCodePtr;
 
 namespace DFG {
 
+enum CompileMode { CompileFunction, CompileOther };
+
 #if ENABLE(DFG_JIT)
 bool tryCompile(JSGlobalData&, CodeBlock*, JITCode&);
 bool tryCompileFunction(JSGlobalData&, CodeBlock*, JITCode&, MacroAssemblerCodePtr& jitCodeWithArityCheck);
+
+// Background compilation takes ownership of the optimizing code block, parses
+// it against the profiles of its alternative and queues the rest of the work
+// on the DFG worklist. The baseline alternative is handed back to the caller,
+// which keeps running it until the result is installed at a safe point.
+bool shouldCompileInBackground(JSGlobalData&);
+PassOwnPtr<CodeBlock> tryCompileInBackground(JSGlobalData&, PassOwnPtr<CodeBlock>);
+PassOwnPtr<CodeBlock> tryCompileFunctionInBackground(JSGlobalData&, PassOwnPtr<CodeBlock>);
 #else
 inline bool tryCompile(JSGlobalData&, CodeBlock*, JITCode&) { return false; }
 inline bool tryCompileFunction(JSGlobalData&, CodeBlock*, JITCode&, MacroAssemblerCodePtr&) { return false; }
+inline bool shouldCompileInBackground(JSGlobalData&) { return false; }
+inline PassOwnPtr<CodeBlock> tryCompileInBackground(JSGlobalData&, PassOwnPtr<CodeBlock>) { return nullptr; }
+inline PassOwnPtr<CodeBlock> tryCompileFunctionInBackground(JSGlobalData&, PassOwnPtr<CodeBlock>) { return nullptr; }
 #endif
 
 } } // namespace JSC::DFG
@@ -326,6 +326,33 @@ void Graph::derefChildren(NodeIndex op)
     DO_TO_CHILDREN(at(op), deref);
 }
 
+void Graph::snapshotBaselineCodeBlocks()
+{
+    SegmentedVector<InlineCallFrame, 4>& inlineCallFrames = m_codeBlock->inlineCallFrames();
+    for (size_t i = 0; i < inlineCallFrames.size(); ++i) {
+        InlineCallFrame* inlineCallFrame = &inlineCallFrames[i];
+        CodeOrigin codeOrigin(0, inlineCallFrame);
+        m_baselineCodeBlocks.add(inlineCallFrame, baselineCodeBlockForOriginAndBaselineCodeBlock(codeOrigin, m_profiledBlock));
+    }
+}
+
+static void addGlobalObjectStructures(HashMap<JSGlobalObject*, Graph::GlobalObjectStructures>& map, JSGlobalObject* globalObject)
+{
+    Graph::GlobalObjectStructures structures;
+    structures.arrayStructure = globalObject->arrayStructure();
+    structures.regExpStructure = globalObject->regExpStructure();
+    structures.emptyObjectStructure = globalObject->emptyObjectStructure();
+    map.add(globalObject, structures);
+}
+
+void Graph::snapshotGlobalObjectStructures()
+{
+    addGlobalObjectStructures(m_globalObjectStructures, m_codeBlock->globalObject());
+    SegmentedVector<InlineCallFrame, 4>& inlineCallFrames = m_codeBlock->inlineCallFrames();
+    for (size_t i = 0; i < inlineCallFrames.size(); ++i)
+        addGlobalObjectStructures(m_globalObjectStructures, m_codeBlock->globalObjectFor(CodeOrigin(0, &inlineCallFrames[i])));
+}
+
 void Graph::predictArgumentTypes()
 {
     ASSERT(m_codeBlock->numParameters() >= 1);
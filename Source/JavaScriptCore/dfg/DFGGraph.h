@@ -258,11 +258,39 @@ public:
         return &m_structureTransitionData.last();
     }
     
+    // Records the baseline code block of every inlined call frame. Finding
+    // them walks the executables of the inlined functions, which only the main
+    // thread may do, so this runs once parsing is done and code generation on a
+    // compiler thread looks the code blocks up here instead.
+    void snapshotBaselineCodeBlocks();
+
+    // The structures given to the objects, arrays and regular expressions that
+    // the graph allocates. They are read from each global object the code
+    // block refers to once parsing is done, since the global object may
+    // replace them while a compiler thread works on the graph.
+    struct GlobalObjectStructures {
+        Structure* arrayStructure;
+        Structure* regExpStructure;
+        Structure* emptyObjectStructure;
+    };
+    void snapshotGlobalObjectStructures();
+
+    GlobalObjectStructures globalObjectStructuresFor(JSGlobalObject* globalObject)
+    {
+        ASSERT(m_globalObjectStructures.contains(globalObject));
+        return m_globalObjectStructures.get(globalObject);
+    }
+
     CodeBlock* baselineCodeBlockFor(const CodeOrigin& codeOrigin)
     {
-        return baselineCodeBlockForOriginAndBaselineCodeBlock(codeOrigin, m_profiledBlock);
+        if (!codeOrigin.inlineCallFrame)
+            return m_profiledBlock;
+        ASSERT(m_baselineCodeBlocks.contains(codeOrigin.inlineCallFrame));
+        return m_baselineCodeBlocks.get(codeOrigin.inlineCallFrame);
     }
     
+    // Only takes the address of the profile; the baseline code keeps writing to
+    // it while the graph is compiled, so the contents must not be read here.
     ValueProfile* valueProfileFor(NodeIndex nodeIndex)
     {
         if (nodeIndex == NoNode)
@@ -298,6 +326,8 @@ public:
     SegmentedVector<VariableAccessData, 16> m_variableAccessData;
     SegmentedVector<StructureSet, 16> m_structureSet;
     SegmentedVector<StructureTransitionData, 8> m_structureTransitionData;
+    HashMap<InlineCallFrame*, CodeBlock*> m_baselineCodeBlocks;
+    HashMap<JSGlobalObject*, GlobalObjectStructures> m_globalObjectStructures;
     BitVector m_preservedVars;
     unsigned m_localVars;
     unsigned m_parameterSlots;
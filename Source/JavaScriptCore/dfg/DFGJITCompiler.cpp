@@ -195,23 +195,52 @@ void JITCompiler::link(LinkBuffer& linkBuffer)
     codeBlock()->shrinkWeakReferenceTransitionsToFit();
 }
 
+JITCompiler::JITCompiler(Graph& dfg)
+    : CCallHelpers(&dfg.m_globalData, dfg.m_codeBlock)
+    , m_graph(dfg)
+    , m_currentCodeOriginIndex(0)
+{
+}
+
+JITCompiler::~JITCompiler()
+{
+}
+
 void JITCompiler::compile(JITCode& entry)
+{
+    generate();
+    linkCode(entry);
+}
+
+void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
+{
+    generateFunction();
+    linkFunctionCode(entry, entryWithArityCheck);
+}
+
+void JITCompiler::generate()
 {
     compileEntry();
-    SpeculativeJIT speculative(*this);
-    compileBody(speculative);
+    m_speculative = adoptPtr(new SpeculativeJIT(*this));
+    compileBody(*m_speculative);
 
     // Create OSR entry trampolines if necessary.
-    speculative.createOSREntries();
+    m_speculative->createOSREntries();
+}
+
+void JITCompiler::linkCode(JITCode& entry)
+{
+    ASSERT(m_speculative);
 
     LinkBuffer linkBuffer(*m_globalData, this, m_codeBlock);
     link(linkBuffer);
-    speculative.linkOSREntries(linkBuffer);
+    m_speculative->linkOSREntries(linkBuffer);
 
     entry = JITCode(linkBuffer.finalizeCode(), JITCode::DFGJIT);
+    m_speculative.clear();
 }
 
-void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
+void JITCompiler::generateFunction()
 {
     compileEntry();
 
@@ -229,8 +258,8 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
 
 
     // === Function body code generation ===
-    SpeculativeJIT speculative(*this);
-    compileBody(speculative);
+    m_speculative = adoptPtr(new SpeculativeJIT(*this));
+    compileBody(*m_speculative);
 
     // === Function footer code generation ===
     //
@@ -245,8 +274,8 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     poke(GPRInfo::callFrameRegister, OBJECT_OFFSETOF(struct JITStackFrame, callFrame) / sizeof(void*));
 
     CallBeginToken token = beginCall();
-    Call callRegisterFileCheck = call();
-    notifyCall(callRegisterFileCheck, CodeOrigin(0), token);
+    m_callRegisterFileCheck = call();
+    notifyCall(m_callRegisterFileCheck, CodeOrigin(0), token);
     jump(fromRegisterFileCheck);
     
     // The fast entry point into a function does not check the correct number of arguments
@@ -254,7 +283,7 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     // determine the correct number of arguments have been passed, or have already checked).
     // In cases where an arity check is necessary, we enter here.
     // FIXME: change this from a cti call to a DFG style operation (normal C calling conventions).
-    Label arityCheck = label();
+    m_arityCheck = label();
     compileEntry();
 
     load32(AssemblyHelpers::payloadFor((VirtualRegister)RegisterFile::ArgumentCount), GPRInfo::regT1);
@@ -262,26 +291,31 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     move(stackPointerRegister, GPRInfo::argumentGPR0);
     poke(GPRInfo::callFrameRegister, OBJECT_OFFSETOF(struct JITStackFrame, callFrame) / sizeof(void*));
     token = beginCall();
-    Call callArityCheck = call();
-    notifyCall(callArityCheck, CodeOrigin(0), token);
+    m_callArityCheck = call();
+    notifyCall(m_callArityCheck, CodeOrigin(0), token);
     move(GPRInfo::regT0, GPRInfo::callFrameRegister);
     jump(fromArityCheck);
     
     // Create OSR entry trampolines if necessary.
-    speculative.createOSREntries();
+    m_speculative->createOSREntries();
+}
 
+void JITCompiler::linkFunctionCode(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
+{
+    ASSERT(m_speculative);
 
     // === Link ===
     LinkBuffer linkBuffer(*m_globalData, this, m_codeBlock);
     link(linkBuffer);
-    speculative.linkOSREntries(linkBuffer);
+    m_speculative->linkOSREntries(linkBuffer);
     
     // FIXME: switch the register file check & arity check over to DFGOpertaion style calls, not JIT stubs.
-    linkBuffer.link(callRegisterFileCheck, cti_register_file_check);
-    linkBuffer.link(callArityCheck, m_codeBlock->m_isConstructor ? cti_op_construct_arityCheck : cti_op_call_arityCheck);
+    linkBuffer.link(m_callRegisterFileCheck, cti_register_file_check);
+    linkBuffer.link(m_callArityCheck, m_codeBlock->m_isConstructor ? cti_op_construct_arityCheck : cti_op_call_arityCheck);
 
-    entryWithArityCheck = linkBuffer.locationOf(arityCheck);
+    entryWithArityCheck = linkBuffer.locationOf(m_arityCheck);
     entry = JITCode(linkBuffer.finalizeCode(), JITCode::DFGJIT);
+    m_speculative.clear();
 }
 
 } } // namespace JSC::DFG
@@ -187,16 +187,21 @@ struct PropertyAccessRecord {
 // call to be linked).
 class JITCompiler : public CCallHelpers {
 public:
-    JITCompiler(Graph& dfg)
-        : CCallHelpers(&dfg.m_globalData, dfg.m_codeBlock)
-        , m_graph(dfg)
-        , m_currentCodeOriginIndex(0)
-    {
-    }
+    JITCompiler(Graph& dfg);
+    ~JITCompiler();
 
     void compile(JITCode& entry);
     void compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck);
 
+    // compile() and compileFunction() split in two. Generating code only reads
+    // the graph and the code block being compiled, so it may run on a compiler
+    // thread; linking allocates executable memory and shares thunks with the
+    // rest of the JSGlobalData, so it must run on the main thread.
+    void generate();
+    void generateFunction();
+    void linkCode(JITCode& entry);
+    void linkFunctionCode(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck);
+
     // Accessors for properties.
     Graph& graph() { return m_graph; }
     
@@ -351,6 +356,12 @@ private:
     Vector<PropertyAccessRecord, 4> m_propertyAccesses;
     Vector<JSCallRecord, 4> m_jsCalls;
     unsigned m_currentCodeOriginIndex;
+
+    // State carried from generate() to linkCode().
+    OwnPtr<SpeculativeJIT> m_speculative;
+    Call m_callRegisterFileCheck;
+    Call m_callArityCheck;
+    Label m_arityCheck;
 };
 
 } } // namespace JSC::DFG
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+
+#include "config.h"
+#include "DFGPlan.h"
+
+#if ENABLE(DFG_JIT)
+
+#include "CodeBlock.h"
+#include "DFGArithNodeFlagsInferencePhase.h"
+#include "DFGByteCodeParser.h"
+#include "DFGCFAPhase.h"
+#include "DFGCSEPhase.h"
+#include "DFGGraph.h"
+#include "DFGJITCompiler.h"
+#include "DFGPredictionPropagationPhase.h"
+#include "DFGVirtualRegisterAllocationPhase.h"
+#include "JSFunction.h"
+#include "SlotVisitor.h"
+
+namespace JSC { namespace DFG {
+
+Plan::Plan(CompileMode compileMode, JSGlobalData& globalData, CodeBlock* codeBlock)
+    : m_compileMode(compileMode)
+    , m_globalData(globalData)
+    , m_codeBlock(codeBlock)
+    , m_profiledBlock(codeBlock->alternative())
+{
+    ASSERT(m_codeBlock);
+    ASSERT(m_profiledBlock);
+    ASSERT(m_profiledBlock->getJITType() == JITCode::BaselineJIT);
+}
+
+Plan::~Plan()
+{
+}
+
+bool Plan::parse()
+{
+#if DFG_ENABLE(DEBUG_VERBOSE)
+    dataLog("DFG compiling code block %p(%p), number of instructions = %u.\n", m_codeBlock, m_profiledBlock, m_codeBlock->instructionCount());
+#endif
+
+    m_graph = adoptPtr(new Graph(m_globalData, m_codeBlock));
+    if (!DFG::parse(*m_graph))
+        return false;
+
+    if (m_compileMode == CompileFunction)
+        m_graph->predictArgumentTypes();
+
+    m_graph->snapshotBaselineCodeBlocks();
+    m_graph->snapshotGlobalObjectStructures();
+    snapshotCells();
+
+    // The JIT compiler finds the baseline code block by walking the chain of
+    // alternatives, which the caller may detach once parsing is done.
+    m_jit = adoptPtr(new JITCompiler(*m_graph));
+    return true;
+}
+
+void Plan::snapshotCells()
+{
+    // The code block being compiled does not belong to any executable yet, so
+    // nothing visits it. Code generation appends to it on the compiler thread,
+    // so copy out what it and the graph refer to while we are still on the
+    // main thread rather than visiting it during a collection.
+    m_cells.append(m_codeBlock->ownerExecutable());
+    m_cells.append(m_codeBlock->globalObject());
+
+    for (size_t i = 0; i < m_codeBlock->numberOfConstantRegisters(); ++i) {
+        JSValue value = m_codeBlock->constantRegister(FirstConstantRegisterIndex + i).get();
+        if (value.isCell())
+            m_cells.append(value.asCell());
+    }
+
+    SegmentedVector<InlineCallFrame, 4>& inlineCallFrames = m_codeBlock->inlineCallFrames();
+    for (size_t i = 0; i < inlineCallFrames.size(); ++i) {
+        m_cells.append(inlineCallFrames[i].executable.get());
+        m_cells.append(inlineCallFrames[i].callee.get());
+    }
+
+    for (HashMap<JSGlobalObject*, Graph::GlobalObjectStructures>::iterator iter = m_graph->m_globalObjectStructures.begin(); iter != m_graph->m_globalObjectStructures.end(); ++iter) {
+        m_cells.append(iter->first);
+        m_cells.append(iter->second.arrayStructure);
+        m_cells.append(iter->second.regExpStructure);
+        m_cells.append(iter->second.emptyObjectStructure);
+    }
+
+    for (size_t i = 0; i < m_graph->m_structureSet.size(); ++i) {
+        StructureSet& structureSet = m_graph->m_structureSet[i];
+        for (size_t j = 0; j < structureSet.size(); ++j)
+            m_cells.append(structureSet[j]);
+    }
+
+    for (size_t i = 0; i < m_graph->m_structureTransitionData.size(); ++i) {
+        m_cells.append(m_graph->m_structureTransitionData[i].previousStructure);
+        m_cells.append(m_graph->m_structureTransitionData[i].newStructure);
+    }
+
+    for (size_t i = 0; i < m_graph->size(); ++i) {
+        Node& node = m_graph->at(i);
+        if (node.isWeakConstant())
+            m_cells.append(node.weakConstant());
+        else if (node.hasFunctionCheckData())
+            m_cells.append(node.function());
+    }
+}
+
+void Plan::visitChildren(SlotVisitor& visitor)
+{
+    for (size_t i = 0; i < m_cells.size(); ++i)
+        visitor.appendUnbarrieredPointer(&m_cells[i]);
+}
+
+void Plan::generate()
+{
+    performArithNodeFlagsInference(*m_graph);
+    performPredictionPropagation(*m_graph);
+    performCSE(*m_graph);
+    performVirtualRegisterAllocation(*m_graph);
+    performCFA(*m_graph);
+
+    if (m_compileMode == CompileFunction)
+        m_jit->generateFunction();
+    else
+        m_jit->generate();
+}
+
+void Plan::link(JITCode& jitCode, MacroAssemblerCodePtr& jitCodeWithArityCheck)
+{
+    if (m_compileMode == CompileFunction)
+        m_jit->linkFunctionCode(jitCode, jitCodeWithArityCheck);
+    else
+        m_jit->linkCode(jitCode);
+}
+
+void Plan::adoptCodeBlock(PassOwnPtr<CodeBlock> codeBlock)
+{
+    ASSERT(codeBlock.get() == m_codeBlock);
+    m_ownedCodeBlock = codeBlock;
+}
+
+PassOwnPtr<CodeBlock> Plan::releaseCodeBlock()
+{
+    ASSERT(m_ownedCodeBlock);
+    return m_ownedCodeBlock.release();
+}
+
+} } // namespace JSC::DFG
+
+#endif // ENABLE(DFG_JIT)
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+
+#ifndef DFGPlan_h
+#define DFGPlan_h
+
+#include <wtf/Platform.h>
+
+#if ENABLE(DFG_JIT)
+
+#include "DFGDriver.h"
+#include <wtf/FastAllocBase.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class CodeBlock;
+class JITCode;
+class JSCell;
+class JSGlobalData;
+class MacroAssemblerCodePtr;
+class SlotVisitor;
+
+namespace DFG {
+
+class Graph;
+class JITCompiler;
+
+// === Plan ===
+//
+// A Plan carries one optimizing compilation through its three stages:
+// parsing, which reads the live value profiles of the baseline code block and
+// must run on the main thread; optimization and code generation, which may run
+// on a compiler thread; and linking, which must run on the main thread again.
+//
+// Code generation reads the graph, the structures and other cells it points
+// at, and what parsing snapshotted into the graph: the baseline code blocks
+// and the structures of the global objects. It takes the addresses of the
+// baseline value profiles but never reads them, since the baseline code keeps
+// updating them. While a plan waits in the worklist, the collector marks the
+// cells the graph refers to as roots; the baseline code blocks stay alive with
+// the executables that own them.
+class Plan {
+    WTF_MAKE_NONCOPYABLE(Plan); WTF_MAKE_FAST_ALLOCATED;
+public:
+    Plan(CompileMode, JSGlobalData&, CodeBlock*);
+    ~Plan();
+
+    bool parse();
+    void generate();
+    void link(JITCode&, MacroAssemblerCodePtr& jitCodeWithArityCheck);
+
+    CompileMode compileMode() const { return m_compileMode; }
+    CodeBlock* codeBlock() const { return m_codeBlock; }
+    CodeBlock* profiledBlock() const { return m_profiledBlock; }
+
+    // Only used by background compilation, where the plan keeps the code block
+    // alive until it is installed or thrown away.
+    void adoptCodeBlock(PassOwnPtr<CodeBlock>);
+    PassOwnPtr<CodeBlock> releaseCodeBlock();
+
+    void visitChildren(SlotVisitor&);
+
+private:
+    void snapshotCells();
+
+    CompileMode m_compileMode;
+    JSGlobalData& m_globalData;
+    CodeBlock* m_codeBlock;
+    CodeBlock* m_profiledBlock;
+    OwnPtr<CodeBlock> m_ownedCodeBlock;
+    OwnPtr<Graph> m_graph;
+    OwnPtr<JITCompiler> m_jit;
+    Vector<JSCell*> m_cells;
+};
+
+} } // namespace JSC::DFG
+
+#endif // ENABLE(DFG_JIT)
+
+#endif // DFGPlan_h
@@ -167,6 +167,7 @@ static bool tryCacheGetByID(ExecState* exec, JSValue baseValue, const Identifier
     JSGlobalData* globalData = &exec->globalData();
     
     if (isJSArray(baseValue) && propertyName == exec->propertyNames().length) {
+        Structure* structure = baseValue.asCell()->structure();
         GPRReg baseGPR = static_cast<GPRReg>(stubInfo.baseGPR);
 #if USE(JSVALUE32_64)
         GPRReg resultTagGPR = static_cast<GPRReg>(stubInfo.valueTagGPR);
@@ -210,8 +211,9 @@ static bool tryCacheGetByID(ExecState* exec, JSValue baseValue, const Identifier
         
         RepatchBuffer repatchBuffer(codeBlock);
         repatchBuffer.relink(stubInfo.callReturnLocation.jumpAtOffset(stubInfo.deltaCallToStructCheck), CodeLocationLabel(stubInfo.stubRoutine.code()));
-        repatchBuffer.relink(stubInfo.callReturnLocation, operationGetById);
+        repatchBuffer.relink(stubInfo.callReturnLocation, operationGetByIdBuildList);
         
+        stubInfo.initGetArrayLength(*globalData, codeBlock->ownerExecutable(), structure);
         return true;
     }
     
@@ -242,9 +244,11 @@ static bool tryCacheGetByID(ExecState* exec, JSValue baseValue, const Identifier
     if (structure->isDictionary())
         return false;
     
-    // FIXME: optimize getters and setters
-    if (slot.cachedPropertyType() != PropertySlot::Value)
-        return false;
+    // Accessors on the prototype chain need a call, which only the list stubs know how to plant.
+    if (slot.cachedPropertyType() != PropertySlot::Value) {
+        dfgRepatchCall(codeBlock, stubInfo.callReturnLocation, operationGetByIdBuildList);
+        return true;
+    }
     
     size_t offset = slot.cachedOffset();
     size_t count = normalizePrototypeChain(exec, baseValue, slot.slotBase(), propertyName, offset);
@@ -259,7 +263,7 @@ static bool tryCacheGetByID(ExecState* exec, JSValue baseValue, const Identifier
     
     RepatchBuffer repatchBuffer(codeBlock);
     repatchBuffer.relink(stubInfo.callReturnLocation.jumpAtOffset(stubInfo.deltaCallToStructCheck), CodeLocationLabel(stubInfo.stubRoutine.code()));
-    repatchBuffer.relink(stubInfo.callReturnLocation, operationGetByIdProtoBuildList);
+    repatchBuffer.relink(stubInfo.callReturnLocation, operationGetByIdBuildList);
     
     stubInfo.initGetByIdChain(*globalData, codeBlock->ownerExecutable(), structure, prototypeChain);
     return true;
@@ -272,45 +276,103 @@ void dfgRepatchGetByID(ExecState* exec, JSValue baseValue, const Identifier& pro
         dfgRepatchCall(exec->codeBlock(), stubInfo.callReturnLocation, operationGetById);
 }
 
+#if DFG_ENABLE(POLYMORPHIC_ACCESS_STATS)
+static void dumpGetByIdListStatistics(ExecState* exec, StructureStubInfo& stubInfo, const Identifier& propertyName, int listSize, bool isMegamorphic)
+{
+    dataLog("DFG get_by_id \"%s\" at bc#%u in %p: %d shape%s%s\n",
+        propertyName.ustring().utf8().data(), stubInfo.codeOrigin.bytecodeIndex, exec->codeBlock(),
+        listSize, listSize == 1 ? "" : "s", isMegamorphic ? ", now generic" : "");
+}
+#endif
+
 static bool tryBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identifier& ident, const PropertySlot& slot, StructureStubInfo& stubInfo)
 {
-    if (!baseValue.isCell()
-        || !slot.isCacheable()
-        || baseValue.asCell()->structure()->isUncacheableDictionary()
-        || slot.slotBase() != baseValue)
+    if (!baseValue.isCell())
         return false;
     
-    if (!stubInfo.registersFlushed) {
-        // We cannot do as much inline caching if the registers were not flushed prior to this GetById. In particular,
-        // non-Value cached properties require planting calls, which requires registers to have been flushed. Thus,
-        // if registers were not flushed, don't do non-Value caching.
-        if (slot.cachedPropertyType() != PropertySlot::Value)
-            return false;
-    }
-    
     CodeBlock* codeBlock = exec->codeBlock();
     JSCell* baseCell = baseValue.asCell();
     Structure* structure = baseCell->structure();
     JSGlobalData* globalData = &exec->globalData();
     
-    ASSERT(slot.slotBase().isObject());
+    bool isArrayLength = isJSArray(baseValue) && ident == exec->propertyNames().length;
+    bool isSelfAccess = false;
+    size_t offset = 0;
+    size_t count = 0;
+    StructureChain* prototypeChain = 0;
+    JSObject* protoObject = 0;
+    
+    if (!isArrayLength) {
+        if (!slot.isCacheable()
+            || structure->isUncacheableDictionary()
+            || structure->typeInfo().prohibitsPropertyCaching())
+            return false;
+        
+        if (!stubInfo.registersFlushed) {
+            // We cannot do as much inline caching if the registers were not flushed prior to this GetById. In particular,
+            // non-Value cached properties require planting calls, which requires registers to have been flushed. Thus,
+            // if registers were not flushed, don't do non-Value caching.
+            if (slot.cachedPropertyType() != PropertySlot::Value)
+                return false;
+        }
+        
+        ASSERT(slot.slotBase().isObject());
+        
+        isSelfAccess = slot.slotBase() == baseValue;
+        offset = slot.cachedOffset();
+        if (!isSelfAccess) {
+            if (structure->isDictionary())
+                return false;
+            // Accessor calls on the prototype chain need a scratch register that
+            // survives the call, so they cannot use the push/pop fallback below.
+            if (slot.cachedPropertyType() != PropertySlot::Value && static_cast<GPRReg>(stubInfo.scratchGPR) == InvalidGPRReg)
+                return false;
+            count = normalizePrototypeChain(exec, baseValue, slot.slotBase(), ident, offset);
+            if (!count)
+                return false;
+            prototypeChain = structure->prototypeChain(exec);
+            protoObject = asObject(slot.slotBase());
+        }
+    }
     
     PolymorphicAccessStructureList* polymorphicStructureList;
     int listIndex;
     
-    if (stubInfo.accessType == access_unset) {
+    switch (stubInfo.accessType) {
+    case access_unset:
         ASSERT(!stubInfo.stubRoutine);
         polymorphicStructureList = new PolymorphicAccessStructureList();
         stubInfo.initGetByIdSelfList(polymorphicStructureList, 0);
         listIndex = 0;
-    } else if (stubInfo.accessType == access_get_by_id_self) {
+        break;
+    case access_get_by_id_self:
         ASSERT(!stubInfo.stubRoutine);
         polymorphicStructureList = new PolymorphicAccessStructureList(*globalData, codeBlock->ownerExecutable(), MacroAssemblerCodeRef::createSelfManagedCodeRef(stubInfo.callReturnLocation.labelAtOffset(stubInfo.deltaCallToSlowCase)), stubInfo.u.getByIdSelf.baseObjectStructure.get(), true);
         stubInfo.initGetByIdSelfList(polymorphicStructureList, 1);
         listIndex = 1;
-    } else {
+        break;
+    case access_get_by_id_chain:
+        // The existing stub fails over to the slow case, so it can serve as
+        // the tail of the list.
+        ASSERT(!!stubInfo.stubRoutine);
+        polymorphicStructureList = new PolymorphicAccessStructureList(*globalData, codeBlock->ownerExecutable(), stubInfo.stubRoutine, stubInfo.u.getByIdChain.baseObjectStructure.get(), stubInfo.u.getByIdChain.chain.get(), true);
+        stubInfo.stubRoutine = MacroAssemblerCodeRef();
+        stubInfo.initGetByIdSelfList(polymorphicStructureList, 1);
+        listIndex = 1;
+        break;
+    case access_get_array_length:
+        ASSERT(!!stubInfo.stubRoutine);
+        polymorphicStructureList = new PolymorphicAccessStructureList(*globalData, codeBlock->ownerExecutable(), stubInfo.stubRoutine, stubInfo.u.getByIdSelf.baseObjectStructure.get(), true);
+        stubInfo.stubRoutine = MacroAssemblerCodeRef();
+        stubInfo.initGetByIdSelfList(polymorphicStructureList, 1);
+        listIndex = 1;
+        break;
+    case access_get_by_id_self_list:
         polymorphicStructureList = stubInfo.u.getByIdSelfList.structureList;
         listIndex = stubInfo.u.getByIdSelfList.listSize;
+        break;
+    default:
+        return false;
     }
     
     if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE) {
@@ -322,12 +384,40 @@ static bool tryBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identi
 #endif
         GPRReg resultGPR = static_cast<GPRReg>(stubInfo.valueGPR);
         GPRReg scratchGPR = static_cast<GPRReg>(stubInfo.scratchGPR);
+        bool needToRestoreScratch = false;
         
         CCallHelpers stubJit(globalData, codeBlock);
         
-        MacroAssembler::Jump wrongStruct = stubJit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR, JSCell::structureOffset()), MacroAssembler::TrustedImmPtr(structure));
+        // Each entry checks one shape and, on mismatch, jumps to the entry that was
+        // added before it. The oldest entry falls through to the slow case, so the
+        // whole list forms a cascade of structure checks.
+        MacroAssembler::JumpList failureCases;
+        
+        if (isArrayLength || count) {
+            if (scratchGPR == InvalidGPRReg) {
+                scratchGPR = SpeculativeJIT::selectScratchGPR(baseGPR, resultGPR);
+                stubJit.push(scratchGPR);
+                needToRestoreScratch = true;
+            }
+        }
+        
+        if (isArrayLength)
+            failureCases.append(stubJit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR, JSCell::classInfoOffset()), MacroAssembler::TrustedImmPtr(&JSArray::s_info)));
+        else
+            failureCases.append(stubJit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR, JSCell::structureOffset()), MacroAssembler::TrustedImmPtr(structure)));
+        
+        if (count) {
+            Structure* currStructure = structure;
+            WriteBarrier<Structure>* it = prototypeChain->head();
+            for (unsigned i = 0; i < count; ++i, ++it) {
+                JSObject* prototype = asObject(currStructure->prototypeForLookup(exec));
+                stubJit.move(MacroAssembler::TrustedImmPtr(prototype), scratchGPR);
+                failureCases.append(stubJit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(scratchGPR, JSCell::structureOffset()), MacroAssembler::TrustedImmPtr(prototype->structure())));
+                currStructure = it->get();
+            }
+        }
         
-        // The strategy we use for stubs is as follows:
+        // The strategy we use for accessor stubs is as follows:
         // 1) Call DFG helper that calls the getter.
         // 2) Check if there was an exception, and if there was, call yet another
         //    helper.
@@ -337,24 +427,49 @@ static bool tryBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identi
         MacroAssembler::Call handlerCall;
         FunctionPtr operationFunction;
         MacroAssembler::Jump success;
+        MacroAssembler::Jump fail;
         
-        if (slot.cachedPropertyType() == PropertySlot::Getter
+        if (isArrayLength) {
+            stubJit.loadPtr(MacroAssembler::Address(baseGPR, JSArray::storageOffset()), scratchGPR);
+            stubJit.load32(MacroAssembler::Address(scratchGPR, OBJECT_OFFSETOF(ArrayStorage, m_length)), scratchGPR);
+            failureCases.append(stubJit.branch32(MacroAssembler::LessThan, scratchGPR, MacroAssembler::TrustedImm32(0)));
+#if USE(JSVALUE64)
+            stubJit.orPtr(GPRInfo::tagTypeNumberRegister, scratchGPR, resultGPR);
+#elif USE(JSVALUE32_64)
+            stubJit.move(scratchGPR, resultGPR);
+            stubJit.move(JITCompiler::TrustedImm32(0xffffffff), resultTagGPR); // JSValue::Int32Tag
+#endif
+            emitRestoreScratch(stubJit, needToRestoreScratch, scratchGPR, success, fail, failureCases);
+            isDirect = true;
+        } else if (slot.cachedPropertyType() == PropertySlot::Getter
             || slot.cachedPropertyType() == PropertySlot::Custom) {
+            ASSERT(!needToRestoreScratch);
             if (slot.cachedPropertyType() == PropertySlot::Getter) {
                 ASSERT(baseGPR != scratchGPR);
-                stubJit.loadPtr(MacroAssembler::Address(baseGPR, JSObject::offsetOfPropertyStorage()), scratchGPR);
+                if (isSelfAccess)
+                    stubJit.loadPtr(MacroAssembler::Address(baseGPR, JSObject::offsetOfPropertyStorage()), scratchGPR);
+                else
+                    stubJit.loadPtr(protoObject->addressOfPropertyStorage(), scratchGPR);
 #if USE(JSVALUE64)
-                stubJit.loadPtr(MacroAssembler::Address(scratchGPR, slot.cachedOffset() * sizeof(JSValue)), scratchGPR);
+                stubJit.loadPtr(MacroAssembler::Address(scratchGPR, offset * sizeof(JSValue)), scratchGPR);
 #elif USE(JSVALUE32_64)
-                stubJit.load32(MacroAssembler::Address(scratchGPR, slot.cachedOffset() * sizeof(JSValue) + OBJECT_OFFSETOF(EncodedValueDescriptor, asBits.payload)), scratchGPR);
+                stubJit.load32(MacroAssembler::Address(scratchGPR, offset * sizeof(JSValue) + OBJECT_OFFSETOF(EncodedValueDescriptor, asBits.payload)), scratchGPR);
 #endif
                 stubJit.setupArgumentsWithExecState(baseGPR, scratchGPR);
                 operationFunction = operationCallGetter;
             } else {
-                stubJit.setupArgumentsWithExecState(
-                    baseGPR,
-                    MacroAssembler::TrustedImmPtr(FunctionPtr(slot.customGetter()).executableAddress()),
-                    MacroAssembler::TrustedImmPtr(const_cast<Identifier*>(&ident)));
+                // Custom getters are called on the object that holds the property.
+                if (isSelfAccess) {
+                    stubJit.setupArgumentsWithExecState(
+                        baseGPR,
+                        MacroAssembler::TrustedImmPtr(FunctionPtr(slot.customGetter()).executableAddress()),
+                        MacroAssembler::TrustedImmPtr(const_cast<Identifier*>(&ident)));
+                } else {
+                    stubJit.setupArgumentsWithExecState(
+                        MacroAssembler::TrustedImmPtr(protoObject),
+                        MacroAssembler::TrustedImmPtr(FunctionPtr(slot.customGetter()).executableAddress()),
+                        MacroAssembler::TrustedImmPtr(const_cast<Identifier*>(&ident)));
+                }
                 operationFunction = operationCallCustomGetter;
             }
             
@@ -378,14 +493,17 @@ static bool tryBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identi
             handlerCall = stubJit.call();
             stubJit.jump(GPRInfo::returnValueGPR2);
         } else {
-            stubJit.loadPtr(MacroAssembler::Address(baseGPR, JSObject::offsetOfPropertyStorage()), resultGPR);
+            if (isSelfAccess)
+                stubJit.loadPtr(MacroAssembler::Address(baseGPR, JSObject::offsetOfPropertyStorage()), resultGPR);
+            else
+                stubJit.loadPtr(protoObject->addressOfPropertyStorage(), resultGPR);
 #if USE(JSVALUE64)
-            stubJit.loadPtr(MacroAssembler::Address(resultGPR, slot.cachedOffset() * sizeof(JSValue)), resultGPR);
+            stubJit.loadPtr(MacroAssembler::Address(resultGPR, offset * sizeof(JSValue)), resultGPR);
 #elif USE(JSVALUE32_64)
-            stubJit.load32(MacroAssembler::Address(resultGPR, slot.cachedOffset() * sizeof(JSValue) + OBJECT_OFFSETOF(EncodedValueDescriptor, asBits.tag)), resultTagGPR);
-            stubJit.load32(MacroAssembler::Address(resultGPR, slot.cachedOffset() * sizeof(JSValue) + OBJECT_OFFSETOF(EncodedValueDescriptor, asBits.payload)), resultGPR);
+            stubJit.load32(MacroAssembler::Address(resultGPR, offset * sizeof(JSValue) + OBJECT_OFFSETOF(EncodedValueDescriptor, asBits.tag)), resultTagGPR);
+            stubJit.load32(MacroAssembler::Address(resultGPR, offset * sizeof(JSValue) + OBJECT_OFFSETOF(EncodedValueDescriptor, asBits.payload)), resultGPR);
 #endif
-            success = stubJit.jump();
+            emitRestoreScratch(stubJit, needToRestoreScratch, scratchGPR, success, fail, failureCases);
             isDirect = true;
         }
 
@@ -398,25 +516,37 @@ static bool tryBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identi
             lastProtoBegin = stubInfo.callReturnLocation.labelAtOffset(stubInfo.deltaCallToSlowCase);
         ASSERT(!!lastProtoBegin);
         
-        patchBuffer.link(wrongStruct, lastProtoBegin);
-        patchBuffer.link(success, stubInfo.callReturnLocation.labelAtOffset(stubInfo.deltaCallToDone));
-        if (!isDirect) {
+        if (isDirect)
+            linkRestoreScratch(patchBuffer, needToRestoreScratch, success, fail, failureCases, stubInfo.callReturnLocation.labelAtOffset(stubInfo.deltaCallToDone), lastProtoBegin);
+        else {
+            patchBuffer.link(failureCases, lastProtoBegin);
+            patchBuffer.link(success, stubInfo.callReturnLocation.labelAtOffset(stubInfo.deltaCallToDone));
             patchBuffer.link(operationCall, operationFunction);
             patchBuffer.link(handlerCall, lookupExceptionHandlerInStub);
         }
         
         MacroAssemblerCodeRef stubRoutine = patchBuffer.finalizeCode();
         
-        polymorphicStructureList->list[listIndex].set(*globalData, codeBlock->ownerExecutable(), stubRoutine, structure, isDirect);
+        if (count)
+            polymorphicStructureList->list[listIndex].set(*globalData, codeBlock->ownerExecutable(), stubRoutine, structure, prototypeChain, isDirect);
+        else
+            polymorphicStructureList->list[listIndex].set(*globalData, codeBlock->ownerExecutable(), stubRoutine, structure, isDirect);
         
         CodeLocationJump jumpLocation = stubInfo.callReturnLocation.jumpAtOffset(stubInfo.deltaCallToStructCheck);
         RepatchBuffer repatchBuffer(codeBlock);
         repatchBuffer.relink(jumpLocation, CodeLocationLabel(stubRoutine.code()));
         
+#if DFG_ENABLE(POLYMORPHIC_ACCESS_STATS)
+        dumpGetByIdListStatistics(exec, stubInfo, ident, listIndex + 1, false);
+#endif
+        
         if (listIndex < (POLYMORPHIC_LIST_CACHE_SIZE - 1))
             return true;
     }
     
+#if DFG_ENABLE(POLYMORPHIC_ACCESS_STATS)
+    dumpGetByIdListStatistics(exec, stubInfo, ident, listIndex, true);
+#endif
     return false;
 }
 
@@ -427,72 +557,6 @@ void dfgBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identifier& p
         dfgRepatchCall(exec->codeBlock(), stubInfo.callReturnLocation, operationGetById);
 }
 
-static bool tryBuildGetByIDProtoList(ExecState* exec, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot, StructureStubInfo& stubInfo)
-{
-    if (!baseValue.isCell()
-        || !slot.isCacheable()
-        || baseValue.asCell()->structure()->isDictionary()
-        || baseValue.asCell()->structure()->typeInfo().prohibitsPropertyCaching()
-        || slot.slotBase() == baseValue
-        || slot.cachedPropertyType() != PropertySlot::Value)
-        return false;
-    
-    ASSERT(slot.slotBase().isObject());
-    
-    size_t offset = slot.cachedOffset();
-    size_t count = normalizePrototypeChain(exec, baseValue, slot.slotBase(), propertyName, offset);
-    if (!count)
-        return false;
-
-    Structure* structure = baseValue.asCell()->structure();
-    StructureChain* prototypeChain = structure->prototypeChain(exec);
-    CodeBlock* codeBlock = exec->codeBlock();
-    JSGlobalData* globalData = &exec->globalData();
-    
-    PolymorphicAccessStructureList* polymorphicStructureList;
-    int listIndex = 1;
-    
-    if (stubInfo.accessType == access_get_by_id_chain) {
-        ASSERT(!!stubInfo.stubRoutine);
-        polymorphicStructureList = new PolymorphicAccessStructureList(*globalData, codeBlock->ownerExecutable(), stubInfo.stubRoutine, stubInfo.u.getByIdChain.baseObjectStructure.get(), stubInfo.u.getByIdChain.chain.get(), true);
-        stubInfo.stubRoutine = MacroAssemblerCodeRef();
-        stubInfo.initGetByIdProtoList(polymorphicStructureList, 1);
-    } else {
-        ASSERT(stubInfo.accessType == access_get_by_id_proto_list);
-        polymorphicStructureList = stubInfo.u.getByIdProtoList.structureList;
-        listIndex = stubInfo.u.getByIdProtoList.listSize;
-    }
-    
-    if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE) {
-        stubInfo.u.getByIdProtoList.listSize++;
-        
-        CodeLocationLabel lastProtoBegin = CodeLocationLabel(polymorphicStructureList->list[listIndex - 1].stubRoutine.code());
-        ASSERT(!!lastProtoBegin);
-
-        MacroAssemblerCodeRef stubRoutine;
-        
-        generateProtoChainAccessStub(exec, stubInfo, prototypeChain, count, offset, structure, stubInfo.callReturnLocation.labelAtOffset(stubInfo.deltaCallToDone), lastProtoBegin, stubRoutine);
-        
-        polymorphicStructureList->list[listIndex].set(*globalData, codeBlock->ownerExecutable(), stubRoutine, structure, true);
-        
-        CodeLocationJump jumpLocation = stubInfo.callReturnLocation.jumpAtOffset(stubInfo.deltaCallToStructCheck);
-        RepatchBuffer repatchBuffer(codeBlock);
-        repatchBuffer.relink(jumpLocation, CodeLocationLabel(stubRoutine.code()));
-        
-        if (listIndex < (POLYMORPHIC_LIST_CACHE_SIZE - 1))
-            return true;
-    }
-    
-    return false;
-}
-
-void dfgBuildGetByIDProtoList(ExecState* exec, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot, StructureStubInfo& stubInfo)
-{
-    bool dontChangeCall = tryBuildGetByIDProtoList(exec, baseValue, propertyName, slot, stubInfo);
-    if (!dontChangeCall)
-        dfgRepatchCall(exec->codeBlock(), stubInfo.callReturnLocation, operationGetById);
-}
-
 static V_DFGOperation_EJCI appropriateGenericPutByIdFunction(const PutPropertySlot &slot, PutKind putKind)
 {
     if (slot.isStrictMode()) {
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+
+#include "config.h"
+#include "DFGWorklist.h"
+
+#if ENABLE(DFG_JIT)
+
+#include "CodeBlock.h"
+#include "DFGPlan.h"
+#include <wtf/CurrentTime.h>
+
+namespace JSC { namespace DFG {
+
+Worklist::Worklist()
+    : m_numberOfActivePlans(0)
+    , m_compileTime(0)
+    , m_shouldQuit(false)
+{
+}
+
+Worklist::~Worklist()
+{
+    {
+        MutexLocker locker(m_lock);
+        m_shouldQuit = true;
+        m_planEnqueued.broadcast();
+    }
+    for (unsigned i = 0; i < m_threads.size(); ++i)
+        waitForThreadCompletion(m_threads[i]);
+
+    deleteAllValues(m_plans);
+}
+
+PassOwnPtr<Worklist> Worklist::create(unsigned numberOfThreads)
+{
+    OwnPtr<Worklist> result = adoptPtr(new Worklist);
+    result->finishCreation(numberOfThreads);
+    return result.release();
+}
+
+void Worklist::finishCreation(unsigned numberOfThreads)
+{
+    ASSERT(numberOfThreads);
+    for (unsigned i = 0; i < numberOfThreads; ++i) {
+        ThreadIdentifier thread = createThread(threadStartFunc, this, "JavaScriptCore::DFG");
+        ASSERT(thread);
+        m_threads.append(thread);
+    }
+}
+
+void Worklist::enqueue(PassOwnPtr<Plan> passedPlan)
+{
+    Plan* plan = passedPlan.leakPtr();
+    MutexLocker locker(m_lock);
+    ASSERT(!m_plans.contains(plan->profiledBlock()));
+    m_plans.add(plan->profiledBlock(), plan);
+    m_queue.append(plan);
+    m_planEnqueued.signal();
+}
+
+Worklist::State Worklist::compilationState(CodeBlock* profiledBlock)
+{
+    MutexLocker locker(m_lock);
+    PlanMap::iterator iter = m_plans.find(profiledBlock);
+    if (iter == m_plans.end())
+        return NotKnown;
+    return m_readyPlans.contains(iter->second) ? Compiled : Compiling;
+}
+
+Worklist::State Worklist::completeCompilation(CodeBlock* profiledBlock)
+{
+    OwnPtr<Plan> plan;
+    {
+        MutexLocker locker(m_lock);
+        PlanMap::iterator iter = m_plans.find(profiledBlock);
+        if (iter == m_plans.end())
+            return NotKnown;
+        if (!m_readyPlans.contains(iter->second))
+            return Compiling;
+        plan = adoptPtr(iter->second);
+        m_readyPlans.remove(iter->second);
+        m_plans.remove(iter);
+    }
+
+    // Anything that could have replaced the baseline code block behind our
+    // back, such as discarding code, cancels every plan first. Collections do
+    // not: they mark the plans' cells, which keeps the executable that owns the
+    // baseline code block alive.
+    ASSERT(profiledBlock->replacement() == profiledBlock);
+
+    JITCode jitCode;
+    MacroAssemblerCodePtr jitCodeWithArityCheck;
+    plan->link(jitCode, jitCodeWithArityCheck);
+
+    OwnPtr<CodeBlock> codeBlock = plan->releaseCodeBlock();
+    profiledBlock->unlinkIncomingCalls();
+    codeBlock->setJITCode(jitCode, jitCodeWithArityCheck);
+    profiledBlock->installOptimizedReplacement(codeBlock.release());
+    return Compiled;
+}
+
+void Worklist::cancelAllPlans()
+{
+    MutexLocker locker(m_lock);
+    m_queue.clear();
+    while (m_numberOfActivePlans)
+        m_planGenerated.wait(m_lock);
+
+    deleteAllValues(m_plans);
+    m_plans.clear();
+    m_readyPlans.clear();
+}
+
+void Worklist::visitChildren(SlotVisitor& visitor)
+{
+    MutexLocker locker(m_lock);
+    PlanMap::iterator end = m_plans.end();
+    for (PlanMap::iterator iter = m_plans.begin(); iter != end; ++iter)
+        iter->second->visitChildren(visitor);
+}
+
+double Worklist::compileTime()
+{
+    MutexLocker locker(m_lock);
+    return m_compileTime;
+}
+
+void Worklist::threadStartFunc(void* worklist)
+{
+    static_cast<Worklist*>(worklist)->threadMain();
+}
+
+void Worklist::threadMain()
+{
+    m_lock.lock();
+    while (!m_shouldQuit) {
+        if (m_queue.isEmpty()) {
+            m_planEnqueued.wait(m_lock);
+            continue;
+        }
+
+        Plan* plan = m_queue.takeFirst();
+        m_numberOfActivePlans++;
+        m_lock.unlock();
+
+        double startTime = monotonicallyIncreasingTime();
+        plan->generate();
+        double compileTime = monotonicallyIncreasingTime() - startTime;
+
+        m_lock.lock();
+        m_readyPlans.add(plan);
+        m_compileTime += compileTime;
+        m_numberOfActivePlans--;
+        m_planGenerated.broadcast();
+    }
+    m_lock.unlock();
+}
+
+} } // namespace JSC::DFG
+
+#endif // ENABLE(DFG_JIT)
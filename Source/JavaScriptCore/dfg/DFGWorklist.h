@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+
+#ifndef DFGWorklist_h
+#define DFGWorklist_h
+
+#include <wtf/Platform.h>
+
+#if ENABLE(DFG_JIT)
+
+#include <wtf/Deque.h>
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class CodeBlock;
+class SlotVisitor;
+
+namespace DFG {
+
+class Plan;
+
+// === Worklist ===
+//
+// Runs the optimization and code generation stages of DFG plans on compiler
+// threads. Plans are keyed by the baseline code block they will replace; the
+// main thread polls for them from the optimization triggers, which are the
+// only places where the replacement can be installed safely.
+class Worklist {
+    WTF_MAKE_NONCOPYABLE(Worklist); WTF_MAKE_FAST_ALLOCATED;
+public:
+    enum State { NotKnown, Compiling, Compiled };
+
+    static PassOwnPtr<Worklist> create(unsigned numberOfThreads);
+    ~Worklist();
+
+    void enqueue(PassOwnPtr<Plan>);
+
+    State compilationState(CodeBlock* profiledBlock);
+
+    // If the plan for the given baseline code block has been generated, links
+    // it and installs it as that code block's replacement.
+    State completeCompilation(CodeBlock* profiledBlock);
+
+    // Throws away every plan, waiting for the ones that are being generated.
+    // Called when code is discarded, since the plans would install code based
+    // on what is being thrown away.
+    void cancelAllPlans();
+
+    // Marks the cells that queued and generated plans refer to. Plans keep
+    // being generated while this runs; they only read these cells.
+    void visitChildren(SlotVisitor&);
+
+    double compileTime();
+
+private:
+    Worklist();
+    void finishCreation(unsigned numberOfThreads);
+
+    static void threadStartFunc(void*);
+    void threadMain();
+
+    Mutex m_lock;
+    ThreadCondition m_planEnqueued;
+    ThreadCondition m_planGenerated;
+
+    typedef HashMap<CodeBlock*, Plan*> PlanMap;
+    PlanMap m_plans;
+    HashSet<Plan*> m_readyPlans;
+    Deque<Plan*> m_queue;
+    unsigned m_numberOfActivePlans;
+    double m_compileTime;
+    bool m_shouldQuit;
+
+    Vector<ThreadIdentifier> m_threads;
+};
+
+} } // namespace JSC::DFG
+
+#endif // ENABLE(DFG_JIT)
+
+#endif // DFGWorklist_h
@@ -84,6 +84,7 @@ private:
     void recycleBlock(CopiedBlock*);
     bool fitsInBlock(CopiedBlock*, size_t);
     CopiedBlock* oversizeBlockFor(void* ptr);
+    void releaseOversizeBlock(CopiedBlock*);
 
     Heap* m_heap;
 
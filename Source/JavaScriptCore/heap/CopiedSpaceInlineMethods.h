@@ -67,8 +67,6 @@ inline void CopiedSpace::init()
 
     m_toSpace = &m_blocks1;
     m_fromSpace = &m_blocks2;
-    
-    m_totalMemoryAllocated += m_blockSize * s_initialBlockNum;
 
     if (!addNewBlock())
         CRASH();
@@ -111,6 +109,7 @@ inline void CopiedSpace::doneCopying()
 
     ASSERT(m_inCopyingPhase);
     m_inCopyingPhase = false;
+    DoublyLinkedList<HeapBlock> emptiedBlocks;
     while (!m_fromSpace->isEmpty()) {
         CopiedBlock* block = static_cast<CopiedBlock*>(m_fromSpace->removeHead());
         if (block->m_isPinned) {
@@ -120,21 +119,39 @@ inline void CopiedSpace::doneCopying()
         }
 
         m_toSpaceSet.remove(block);
+        emptiedBlocks.push(block);
+    }
+
+    // Keep enough emptied blocks to copy the surviving storage once more, and
+    // give the rest back to the OS now rather than waiting for the block
+    // freeing thread to trim the shared pool.
+    size_t blocksToKeep = m_toSpaceSet.size();
+    if (blocksToKeep < s_initialBlockNum)
+        blocksToKeep = s_initialBlockNum;
+    while (!emptiedBlocks.isEmpty()) {
+        CopiedBlock* block = static_cast<CopiedBlock*>(emptiedBlocks.removeHead());
         {
             MutexLocker locker(m_heap->m_freeBlockLock);
-            m_heap->m_freeBlocks.push(block);
-            m_heap->m_numberOfFreeBlocks++;
+            if (m_heap->m_numberOfFreeBlocks < blocksToKeep) {
+                m_heap->m_freeBlocks.push(block);
+                m_heap->m_numberOfFreeBlocks++;
+                block = 0;
+            }
         }
+        {
+            MutexLocker locker(m_memoryStatsLock);
+            m_totalMemoryAllocated -= m_blockSize;
+        }
+        if (block)
+            block->m_allocation.deallocate();
     }
 
     CopiedBlock* curr = static_cast<CopiedBlock*>(m_oversizeBlocks.head());
     while (curr) {
         CopiedBlock* next = static_cast<CopiedBlock*>(curr->next());
         if (!curr->m_isPinned) {
-            m_oversizeBlocks.remove(curr);
-            m_totalMemoryAllocated -= curr->m_allocation.size();
             m_totalMemoryUtilized -= curr->m_allocation.size() - sizeof(CopiedBlock);
-            curr->m_allocation.deallocate();
+            releaseOversizeBlock(curr);
         } else
             curr->m_isPinned = false;
         curr = next;
@@ -185,6 +202,11 @@ inline void CopiedSpace::recycleBlock(CopiedBlock* block)
         m_heap->m_numberOfFreeBlocks++;
     }
 
+    {
+        MutexLocker locker(m_memoryStatsLock);
+        m_totalMemoryAllocated -= m_blockSize;
+    }
+
     {
         MutexLocker locker(m_loanedBlocksLock);
         ASSERT(m_numberOfLoanedBlocks > 0);
@@ -205,9 +227,15 @@ inline CheckedBoolean CopiedSpace::getFreshBlock(AllocationEffort allocationEffo
             m_heap->m_numberOfFreeBlocks--;
         }
     }
-    if (heapBlock)
+    if (heapBlock) {
+        // Blocks in the shared pool belong to no space, so the copied space
+        // counts them from the moment it takes one until it gives it back.
+        {
+            MutexLocker locker(m_memoryStatsLock);
+            m_totalMemoryAllocated += m_blockSize;
+        }
         block = new (NotNull, heapBlock) CopiedBlock(heapBlock->m_allocation);
-    else if (allocationEffort == AllocationMustSucceed) {
+    } else if (allocationEffort == AllocationMustSucceed) {
         if (!allocateNewBlock(&block)) {
             *outBlock = 0;
             ASSERT_NOT_REACHED();
@@ -370,6 +398,16 @@ inline CheckedBoolean CopiedSpace::tryReallocateOversize(void** ptr, size_t oldS
     ASSERT(newSize > oldSize);
 
     void* oldPtr = *ptr;
+
+    // Oversize allocations are rounded up to whole pages, so a growing
+    // butterfly often still fits in the allocation it already has.
+    if (isOversize(oldSize)) {
+        CopiedBlock* oldBlock = oversizeBlockFor(oldPtr);
+        if (static_cast<char*>(oldPtr) + newSize <= static_cast<char*>(oldBlock->m_allocation.base()) + oldBlock->m_allocation.size()) {
+            m_totalMemoryUtilized += newSize - oldSize;
+            return true;
+        }
+    }
     
     void* newPtr = 0;
     if (!tryAllocateOversize(newSize, &newPtr)) {
@@ -378,12 +416,8 @@ inline CheckedBoolean CopiedSpace::tryReallocateOversize(void** ptr, size_t oldS
     }
     memcpy(newPtr, oldPtr, oldSize);
 
-    if (isOversize(oldSize)) {
-        CopiedBlock* oldBlock = oversizeBlockFor(oldPtr);
-        m_oversizeBlocks.remove(oldBlock);
-        oldBlock->m_allocation.deallocate();
-        m_totalMemoryAllocated -= oldSize + sizeof(CopiedBlock);
-    }
+    if (isOversize(oldSize))
+        releaseOversizeBlock(oversizeBlockFor(oldPtr));
     
     m_totalMemoryUtilized -= oldSize;
 
@@ -391,6 +425,15 @@ inline CheckedBoolean CopiedSpace::tryReallocateOversize(void** ptr, size_t oldS
     return true;
 }
 
+inline void CopiedSpace::releaseOversizeBlock(CopiedBlock* block)
+{
+    // Oversize blocks are never pooled: each one is its own OS allocation,
+    // sized for a single butterfly, and is returned as soon as it dies.
+    m_oversizeBlocks.remove(block);
+    m_totalMemoryAllocated -= block->m_allocation.size();
+    block->m_allocation.deallocate();
+}
+
 inline bool CopiedSpace::isOversize(size_t bytes)
 {
     return bytes > m_maxAllocationSize;
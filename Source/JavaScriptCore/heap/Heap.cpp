@@ -25,6 +25,7 @@
 #include "CopiedSpaceInlineMethods.h"
 #include "CodeBlock.h"
 #include "ConservativeRoots.h"
+#include "DFGWorklist.h"
 #include "GCActivityCallback.h"
 #include "HeapRootVisitor.h"
 #include "Interpreter.h"
@@ -368,6 +369,10 @@ void Heap::destroy()
 #if ENABLE(JIT)
     m_globalData->jitStubs->clearHostFunctionStubs();
 #endif
+#if ENABLE(DFG_JIT)
+    if (m_globalData->dfgWorklist)
+        m_globalData->dfgWorklist->cancelAllPlans();
+#endif
 
     delete m_markListSet;
     m_markListSet = 0;
@@ -625,6 +630,14 @@ void Heap::markRoots(bool fullGC)
                 m_globalData->codeBlocksBeingCompiled[i]->visitAggregate(visitor);
         }
     
+#if ENABLE(DFG_JIT)
+        if (m_globalData->dfgWorklist) {
+            GCPHASE(VisitDFGPlans);
+            m_globalData->dfgWorklist->visitChildren(visitor);
+            visitor.donateAndDrain();
+        }
+#endif
+
         {
             GCPHASE(VisitMachineRoots);
             visitor.append(machineThreadRoots);
@@ -823,6 +836,9 @@ void Heap::collect(SweepToggle sweepToggle)
         GCPHASE(Sweeping);
         sweep();
         shrink();
+    } else {
+        GCPHASE(StartBackgroundSweeping);
+        m_objectSpace.startSweepingInBackground();
     }
 
     // To avoid pathological GC churn in large heaps, we set the allocation high
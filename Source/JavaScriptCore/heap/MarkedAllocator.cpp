@@ -10,7 +10,7 @@ inline void* MarkedAllocator::tryAllocateHelper()
     MarkedBlock::FreeCell* firstFreeCell = m_firstFreeCell;
     if (!firstFreeCell) {
         for (MarkedBlock*& block = m_currentBlock; block; block = static_cast<MarkedBlock*>(block->next())) {
-            firstFreeCell = block->sweep(MarkedBlock::SweepToFreeList);
+            firstFreeCell = m_markedSpace->sweepToFreeList(block);
             if (firstFreeCell)
                 break;
             m_markedSpace->didConsumeFreeList(block);
@@ -85,17 +85,7 @@ void* MarkedAllocator::allocateSlowCase()
     
 MarkedBlock* MarkedAllocator::allocateBlock(AllocationEffort allocationEffort)
 {
-    MarkedBlock* block;
-    
-    {
-        MutexLocker locker(m_heap->m_freeBlockLock);
-        if (m_heap->m_numberOfFreeBlocks) {
-            block = static_cast<MarkedBlock*>(m_heap->m_freeBlocks.removeHead());
-            ASSERT(block);
-            m_heap->m_numberOfFreeBlocks--;
-        } else
-            block = 0;
-    }
+    MarkedBlock* block = static_cast<MarkedBlock*>(m_markedSpace->takeFreeBlock());
     if (block)
         block = MarkedBlock::recycle(block, m_heap, m_cellSize, m_cellsNeedDestruction);
     else if (allocationEffort == AllocationCanFail)
@@ -116,6 +116,7 @@ namespace JSC {
         void clearMarks();
         size_t markCount();
         bool markCountIsZero(); // Faster than markCount().
+        bool needsSweeping(); // True from the end of marking until the block is first swept.
 
         size_t cellSize();
         bool cellsNeedDestruction();
@@ -244,6 +245,11 @@ namespace JSC {
         return m_marks.isEmpty();
     }
 
+    inline bool MarkedBlock::needsSweeping()
+    {
+        return m_state == Marked;
+    }
+
     inline size_t MarkedBlock::cellSize()
     {
         return m_atomsPerCell * atomSize;
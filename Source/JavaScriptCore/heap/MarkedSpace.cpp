@@ -25,6 +25,7 @@
 #include "JSLock.h"
 #include "JSObject.h"
 #include "ScopeChain.h"
+#include <wtf/CurrentTime.h>
 
 namespace JSC {
 
@@ -34,6 +35,10 @@ MarkedSpace::MarkedSpace(Heap* heap)
     : m_waterMark(0)
     , m_nurseryWaterMark(0)
     , m_heap(heap)
+    , m_blockBeingSwept(0)
+    , m_backgroundSweepTime(0)
+    , m_isSweepingInBackground(false)
+    , m_sweeperShouldQuit(false)
 {
     for (size_t cellSize = preciseStep; cellSize <= preciseCutoff; cellSize += preciseStep) {
         allocatorFor(cellSize).init(heap, this, cellSize, false);
@@ -44,10 +49,26 @@ MarkedSpace::MarkedSpace(Heap* heap)
         allocatorFor(cellSize).init(heap, this, cellSize, false);
         destructorAllocatorFor(cellSize).init(heap, this, cellSize, true);
     }
+
+    m_sweeperThread = createThread(sweeperThreadStartFunc, this, "JavaScriptCore::Sweeper");
+    ASSERT(m_sweeperThread);
+}
+
+MarkedSpace::~MarkedSpace()
+{
+    ASSERT(!m_isSweepingInBackground);
+    {
+        MutexLocker locker(m_sweeperLock);
+        m_sweeperShouldQuit = true;
+        m_sweeperCondition.broadcast();
+    }
+    waitForThreadCompletion(m_sweeperThread);
 }
 
 void MarkedSpace::resetAllocators()
 {
+    returnCachedFreeBlocks();
+
     m_waterMark = 0;
     m_nurseryWaterMark = 0;
 
@@ -64,6 +85,8 @@ void MarkedSpace::resetAllocators()
 
 void MarkedSpace::canonicalizeCellLivenessData()
 {
+    stopSweepingInBackground();
+
     for (size_t cellSize = preciseStep; cellSize <= preciseCutoff; cellSize += preciseStep) {
         allocatorFor(cellSize).zapFreeList();
         destructorAllocatorFor(cellSize).zapFreeList();
@@ -78,16 +101,53 @@ void MarkedSpace::canonicalizeCellLivenessData()
 
 void MarkedSpace::freeBlocks(MarkedBlock* head)
 {
+    Vector<MarkedBlock*, 32> freedBlocks;
     MarkedBlock* next;
     for (MarkedBlock* block = head; block; block = next) {
         next = static_cast<MarkedBlock*>(block->next());
         
         m_blocks.remove(block);
         block->sweep();
+        freedBlocks.append(block);
+    }
+
+    MutexLocker locker(m_heap->m_freeBlockLock);
+    for (size_t i = 0; i < freedBlocks.size(); ++i)
+        m_heap->m_freeBlocks.append(freedBlocks[i]);
+    m_heap->m_numberOfFreeBlocks += freedBlocks.size();
+}
+
+HeapBlock* MarkedSpace::takeFreeBlock()
+{
+    if (m_cachedFreeBlocks.isEmpty()) {
         MutexLocker locker(m_heap->m_freeBlockLock);
-        m_heap->m_freeBlocks.append(block);
-        m_heap->m_numberOfFreeBlocks++;
+        while (m_heap->m_numberOfFreeBlocks && m_cachedFreeBlocks.size() < freeBlockBatchSize) {
+            HeapBlock* block = m_heap->m_freeBlocks.removeHead();
+            ASSERT(block);
+            m_heap->m_numberOfFreeBlocks--;
+            m_cachedFreeBlocks.append(block);
+        }
+        if (m_cachedFreeBlocks.isEmpty())
+            return 0;
     }
+
+    HeapBlock* block = m_cachedFreeBlocks.last();
+    m_cachedFreeBlocks.removeLast();
+    return block;
+}
+
+void MarkedSpace::returnCachedFreeBlocks()
+{
+    // Cached blocks are invisible to the block freeing thread and to the
+    // copied space, so hand them back whenever the heap is reset or shrunk.
+    if (m_cachedFreeBlocks.isEmpty())
+        return;
+
+    MutexLocker locker(m_heap->m_freeBlockLock);
+    for (size_t i = 0; i < m_cachedFreeBlocks.size(); ++i)
+        m_heap->m_freeBlocks.push(m_cachedFreeBlocks[i]);
+    m_heap->m_numberOfFreeBlocks += m_cachedFreeBlocks.size();
+    m_cachedFreeBlocks.clear();
 }
 
 class TakeIfUnmarked {
@@ -124,9 +184,128 @@ inline TakeIfUnmarked::ReturnType TakeIfUnmarked::returnValue()
 
 void MarkedSpace::shrink()
 {
+    ASSERT(!m_isSweepingInBackground);
+
     // We record a temporary list of empties to avoid modifying m_blocks while iterating it.
     TakeIfUnmarked takeIfUnmarked(this);
     freeBlocks(forEachBlock(takeIfUnmarked));
+    returnCachedFreeBlocks();
+}
+
+class CollectBlocksToSweep : public MarkedBlock::VoidFunctor {
+public:
+    CollectBlocksToSweep(Deque<MarkedBlock*>&);
+    void operator()(MarkedBlock*);
+
+private:
+    Deque<MarkedBlock*>& m_blocks;
+};
+
+inline CollectBlocksToSweep::CollectBlocksToSweep(Deque<MarkedBlock*>& blocks)
+    : m_blocks(blocks)
+{
+}
+
+inline void CollectBlocksToSweep::operator()(MarkedBlock* block)
+{
+    // Destructors may touch state that is not thread safe, so blocks that
+    // need them are left for the allocator to sweep on the main thread.
+    if (block->cellsNeedDestruction() || !block->needsSweeping())
+        return;
+    m_blocks.append(block);
+}
+
+void MarkedSpace::startSweepingInBackground()
+{
+    ASSERT(!m_isSweepingInBackground);
+
+    MutexLocker locker(m_sweeperLock);
+    ASSERT(m_blocksToSweep.isEmpty());
+    ASSERT(m_sweptFreeLists.isEmpty());
+
+    CollectBlocksToSweep collectBlocksToSweep(m_blocksToSweep);
+    forEachBlock(collectBlocksToSweep);
+    if (m_blocksToSweep.isEmpty())
+        return;
+
+    m_isSweepingInBackground = true;
+    m_sweeperCondition.broadcast();
+}
+
+void MarkedSpace::stopSweepingInBackground()
+{
+    if (!m_isSweepingInBackground)
+        return;
+
+    MutexLocker locker(m_sweeperLock);
+    m_blocksToSweep.clear();
+    while (m_blockBeingSwept)
+        m_sweeperCondition.wait(m_sweeperLock);
+
+    // Free lists that no allocator has claimed yet are rolled back the same
+    // way an allocator's current free list is, leaving their blocks Zapped.
+    HashMap<MarkedBlock*, MarkedBlock::FreeCell*>::iterator end = m_sweptFreeLists.end();
+    for (HashMap<MarkedBlock*, MarkedBlock::FreeCell*>::iterator it = m_sweptFreeLists.begin(); it != end; ++it)
+        it->first->zapFreeList(it->second);
+    m_sweptFreeLists.clear();
+
+    m_isSweepingInBackground = false;
+}
+
+MarkedBlock::FreeCell* MarkedSpace::sweepToFreeList(MarkedBlock* block)
+{
+    if (!m_isSweepingInBackground)
+        return block->sweep(MarkedBlock::SweepToFreeList);
+
+    MutexLocker locker(m_sweeperLock);
+    while (m_blockBeingSwept == block)
+        m_sweeperCondition.wait(m_sweeperLock);
+
+    HashMap<MarkedBlock*, MarkedBlock::FreeCell*>::iterator it = m_sweptFreeLists.find(block);
+    if (it != m_sweptFreeLists.end()) {
+        MarkedBlock::FreeCell* freeList = it->second;
+        m_sweptFreeLists.remove(it);
+        return freeList;
+    }
+
+    // The sweeper has not reached this block yet. Holding the lock keeps it
+    // from picking the block up while we sweep it here; once swept, the block
+    // no longer needs sweeping and the sweeper will skip it.
+    return block->sweep(MarkedBlock::SweepToFreeList);
+}
+
+void MarkedSpace::sweeperThreadStartFunc(void* markedSpace)
+{
+    static_cast<MarkedSpace*>(markedSpace)->sweeperThreadMain();
+}
+
+void MarkedSpace::sweeperThreadMain()
+{
+    m_sweeperLock.lock();
+    while (!m_sweeperShouldQuit) {
+        if (m_blocksToSweep.isEmpty()) {
+            m_sweeperCondition.wait(m_sweeperLock);
+            continue;
+        }
+
+        MarkedBlock* block = m_blocksToSweep.takeFirst();
+        if (!block->needsSweeping())
+            continue;
+
+        m_blockBeingSwept = block;
+        m_sweeperLock.unlock();
+
+        double startTime = monotonicallyIncreasingTime();
+        MarkedBlock::FreeCell* freeList = block->sweep(MarkedBlock::SweepToFreeList);
+        double sweepTime = monotonicallyIncreasingTime() - startTime;
+
+        m_sweeperLock.lock();
+        m_sweptFreeLists.set(block, freeList);
+        m_backgroundSweepTime += sweepTime;
+        m_blockBeingSwept = 0;
+        m_sweeperCondition.broadcast();
+    }
+    m_sweeperLock.unlock();
 }
 
 #if ENABLE(GGC)
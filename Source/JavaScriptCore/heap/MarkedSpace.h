@@ -28,10 +28,13 @@
 #include "MarkedBlockSet.h"
 #include "PageAllocationAligned.h"
 #include <wtf/Bitmap.h>
+#include <wtf/Deque.h>
 #include <wtf/DoublyLinkedList.h>
 #include <wtf/FixedArray.h>
+#include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/Threading.h>
 #include <wtf/Vector.h>
 
 #define ASSERT_CLASS_FITS_IN_CELL(class) COMPILE_ASSERT(sizeof(class) <= MarkedSpace::maxCellSize, class_fits_in_cell)
@@ -50,6 +53,7 @@ public:
     static const size_t maxCellSize = 2048;
 
     MarkedSpace(Heap*);
+    ~MarkedSpace();
 
     MarkedAllocator& allocatorFor(size_t);
     MarkedAllocator& allocatorFor(MarkedBlock*);
@@ -75,10 +79,23 @@ public:
     
     void shrink();
     void freeBlocks(MarkedBlock* head);
+    HeapBlock* takeFreeBlock();
+    void returnCachedFreeBlocks();
     void didAddBlock(MarkedBlock*);
     void didConsumeFreeList(MarkedBlock*);
 
+    // Blocks without destructors are swept on a background thread after a
+    // collection that did not sweep eagerly. Allocators pick up the free
+    // lists it produces through sweepToFreeList().
+    void startSweepingInBackground();
+    void stopSweepingInBackground();
+    MarkedBlock::FreeCell* sweepToFreeList(MarkedBlock*);
+    double backgroundSweepTime(); // Total seconds spent sweeping off the main thread.
+
 private:
+    void sweeperThreadMain();
+    static void sweeperThreadStartFunc(void* markedSpace);
+
     // [ 32... 256 ]
     static const size_t preciseStep = MarkedBlock::atomSize;
     static const size_t preciseCutoff = 256;
@@ -94,13 +111,29 @@ private:
         FixedArray<MarkedAllocator, impreciseCount> impreciseAllocators;
     };
 
+    // Recycled blocks are taken from the heap's free list in batches, so
+    // refilling allocators takes m_freeBlockLock once per batch instead of
+    // once per block.
+    static const size_t freeBlockBatchSize = 8;
+
     Subspace m_destructorSpace;
     Subspace m_normalSpace;
+    Vector<HeapBlock*, freeBlockBatchSize> m_cachedFreeBlocks;
 
     size_t m_waterMark;
     size_t m_nurseryWaterMark;
     Heap* m_heap;
     MarkedBlockSet m_blocks;
+
+    ThreadIdentifier m_sweeperThread;
+    Mutex m_sweeperLock;
+    ThreadCondition m_sweeperCondition;
+    Deque<MarkedBlock*> m_blocksToSweep;
+    HashMap<MarkedBlock*, MarkedBlock::FreeCell*> m_sweptFreeLists;
+    MarkedBlock* m_blockBeingSwept;
+    double m_backgroundSweepTime;
+    bool m_isSweepingInBackground; // Only touched by the thread that owns the heap.
+    bool m_sweeperShouldQuit;
 };
 
 inline size_t MarkedSpace::waterMark()
@@ -183,6 +216,12 @@ template <typename Functor> inline typename Functor::ReturnType MarkedSpace::for
     return forEachBlock(functor);
 }
 
+inline double MarkedSpace::backgroundSweepTime()
+{
+    MutexLocker locker(m_sweeperLock);
+    return m_backgroundSweepTime;
+}
+
 inline void MarkedSpace::didAddBlock(MarkedBlock* block)
 {
     m_blocks.add(block);
@@ -75,6 +75,13 @@ namespace JSC {
 class JSGlobalData;
 void releaseExecutableMemory(JSGlobalData&);
 
+// Code that has a fallback, such as an interpreter, can ask for a null handle
+// rather than a crash when executable memory runs out.
+enum JITCompilationEffort {
+    JITCompilationCanFail,
+    JITCompilationMustSucceed
+};
+
 inline size_t roundUpAllocationSize(size_t request, size_t granularity)
 {
     if ((std::numeric_limits<size_t>::max() - granularity) <= request)
@@ -113,7 +120,7 @@ public:
     static void dumpProfile() { }
 #endif
 
-    PassRefPtr<ExecutableMemoryHandle> allocate(JSGlobalData&, size_t sizeInBytes, void* ownerUID);
+    PassRefPtr<ExecutableMemoryHandle> allocate(JSGlobalData&, size_t sizeInBytes, void* ownerUID, JITCompilationEffort = JITCompilationMustSucceed);
 
 #if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
     static void makeWritable(void* start, size_t size)
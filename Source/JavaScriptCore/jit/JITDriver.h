@@ -42,6 +42,13 @@ inline bool jitCompileIfAppropriate(JSGlobalData& globalData, OwnPtr<CodeBlockTy
     if (!globalData.canUseJIT())
         return true;
     
+    if (jitType == JITCode::DFGJIT && DFG::shouldCompileInBackground(globalData)) {
+        // The executable keeps running the baseline code block until the DFG
+        // worklist installs the optimized one.
+        codeBlock = static_pointer_cast<CodeBlockType>(DFG::tryCompileInBackground(globalData, static_pointer_cast<CodeBlock>(codeBlock.release())));
+        return false;
+    }
+
     bool dfgCompiled = false;
     if (jitType == JITCode::DFGJIT)
         dfgCompiled = DFG::tryCompile(globalData, codeBlock.get(), jitCode);
@@ -65,6 +72,12 @@ inline bool jitCompileFunctionIfAppropriate(JSGlobalData& globalData, OwnPtr<Fun
     if (!globalData.canUseJIT())
         return true;
     
+    if (jitType == JITCode::DFGJIT && DFG::shouldCompileInBackground(globalData)) {
+        codeBlock = static_pointer_cast<FunctionCodeBlock>(DFG::tryCompileFunctionInBackground(globalData, static_pointer_cast<CodeBlock>(codeBlock.release())));
+        symbolTable = codeBlock->sharedSymbolTable();
+        return false;
+    }
+
     bool dfgCompiled = false;
     if (jitType == JITCode::DFGJIT)
         dfgCompiled = DFG::tryCompileFunction(globalData, codeBlock.get(), jitCode, jitCodeWithArityCheck);
@@ -39,6 +39,7 @@
 #include "CodeBlock.h"
 #include "CodeProfiling.h"
 #include "DFGOSREntry.h"
+#include "DFGWorklist.h"
 #include "Debugger.h"
 #include "ExceptionHelpers.h"
 #include "GetterSetter.h"
@@ -1946,24 +1947,40 @@ DEFINE_STUB_FUNCTION(void, optimize_from_loop)
             return;
         }
     } else {
-        if (!codeBlock->shouldOptimizeNow()) {
+        // This trigger is a safe point, so it is where code compiled in the
+        // background gets installed.
+        DFG::Worklist* worklist = stackFrame.globalData->dfgWorklist.get();
+        DFG::Worklist::State compilationState = worklist ? worklist->completeCompilation(codeBlock) : DFG::Worklist::NotKnown;
+        if (compilationState == DFG::Worklist::NotKnown) {
+            if (!codeBlock->shouldOptimizeNow()) {
 #if ENABLE(JIT_VERBOSE_OSR)
-            dataLog("Delaying optimization for %p (in loop) because of insufficient profiling.\n", codeBlock);
+                dataLog("Delaying optimization for %p (in loop) because of insufficient profiling.\n", codeBlock);
 #endif
-            return;
-        }
-        
-        ScopeChainNode* scopeChain = callFrame->scopeChain();
-        
-        JSObject* error = codeBlock->compileOptimized(callFrame, scopeChain);
+                return;
+            }
+            
+            ScopeChainNode* scopeChain = callFrame->scopeChain();
+            
+            JSObject* error = codeBlock->compileOptimized(callFrame, scopeChain);
 #if ENABLE(JIT_VERBOSE_OSR)
-        if (error)
-            dataLog("WARNING: optimized compilation from loop failed.\n");
+            if (error)
+                dataLog("WARNING: optimized compilation from loop failed.\n");
 #else
-        UNUSED_PARAM(error);
+            UNUSED_PARAM(error);
 #endif
+            if (worklist)
+                compilationState = worklist->compilationState(codeBlock);
+        }
         
         if (codeBlock->replacement() == codeBlock) {
+            if (compilationState != DFG::Worklist::NotKnown) {
+#if ENABLE(JIT_VERBOSE_OSR)
+                dataLog("Optimizing %p (in loop) in the background.\n", codeBlock);
+#endif
+                codeBlock->optimizeSoon();
+                return;
+            }
+            
 #if ENABLE(JIT_VERBOSE_OSR)
             dataLog("Optimizing %p from loop failed.\n", codeBlock);
 #endif
@@ -2051,20 +2068,34 @@ DEFINE_STUB_FUNCTION(void, optimize_from_ret)
         return;
     }
     
-    if (!codeBlock->shouldOptimizeNow()) {
+    DFG::Worklist* worklist = stackFrame.globalData->dfgWorklist.get();
+    DFG::Worklist::State compilationState = worklist ? worklist->completeCompilation(codeBlock) : DFG::Worklist::NotKnown;
+    if (compilationState == DFG::Worklist::NotKnown) {
+        if (!codeBlock->shouldOptimizeNow()) {
 #if ENABLE(JIT_VERBOSE_OSR)
-        dataLog("Delaying optimization for %p (in return) because of insufficient profiling.\n", codeBlock);
+            dataLog("Delaying optimization for %p (in return) because of insufficient profiling.\n", codeBlock);
 #endif
-        return;
-    }
-    
-    ScopeChainNode* scopeChain = callFrame->scopeChain();
+            return;
+        }
+        
+        ScopeChainNode* scopeChain = callFrame->scopeChain();
 
-    JSObject* error = codeBlock->compileOptimized(callFrame, scopeChain);
-    if (error)
-        dataLog("WARNING: optimized compilation from ret failed.\n");
+        JSObject* error = codeBlock->compileOptimized(callFrame, scopeChain);
+        if (error)
+            dataLog("WARNING: optimized compilation from ret failed.\n");
+        if (worklist)
+            compilationState = worklist->compilationState(codeBlock);
+    }
     
     if (codeBlock->replacement() == codeBlock) {
+        if (compilationState != DFG::Worklist::NotKnown) {
+#if ENABLE(JIT_VERBOSE_OSR)
+            dataLog("Optimizing %p (in return) in the background.\n", codeBlock);
+#endif
+            codeBlock->optimizeSoon();
+            return;
+        }
+        
 #if ENABLE(JIT_VERBOSE_OSR)
         dataLog("Optimizing %p from return failed.\n", codeBlock);
 #endif
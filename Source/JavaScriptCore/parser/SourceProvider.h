@@ -33,6 +33,7 @@
 #include "UString.h"
 #include <wtf/PassOwnPtr.h>
 #include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
 #include <wtf/UnusedParam.h>
 #include <wtf/text/TextPosition.h>
 
@@ -40,19 +41,16 @@ namespace JSC {
 
     class SourceProvider : public RefCounted<SourceProvider> {
     public:
-        SourceProvider(const UString& url, const TextPosition& startPosition, SourceProviderCache* cache = 0)
+        SourceProvider(const UString& url, const TextPosition& startPosition, PassRefPtr<SourceProviderCache> cache = 0)
             : m_url(url)
             , m_startPosition(startPosition)
             , m_validated(false)
-            , m_cache(cache ? cache : new SourceProviderCache)
-            , m_cacheOwned(!cache)
+            , m_cache(cache ? cache : SourceProviderCache::create())
         {
             deprecatedTurnOffVerifier();
         }
         virtual ~SourceProvider()
         {
-            if (m_cacheOwned)
-                delete m_cache;
         }
 
         virtual UString getRange(int start, int end) const = 0;
@@ -66,8 +64,8 @@ namespace JSC {
         bool isValid() const { return m_validated; }
         void setValid() { m_validated = true; }
 
-        SourceProviderCache* cache() const { return m_cache; }
-        void notifyCacheSizeChanged(int delta) { if (!m_cacheOwned) cacheSizeChanged(delta); }
+        SourceProviderCache* cache() const { return m_cache.get(); }
+        void notifyCacheSizeChanged(int delta) { cacheSizeChanged(delta); }
         
     private:
         virtual void cacheSizeChanged(int delta) { UNUSED_PARAM(delta); }
@@ -75,8 +73,7 @@ namespace JSC {
         UString m_url;
         TextPosition m_startPosition;
         bool m_validated;
-        SourceProviderCache* m_cache;
-        bool m_cacheOwned;
+        RefPtr<SourceProviderCache> m_cache;
     };
 
     class UStringSourceProvider : public SourceProvider {
@@ -26,8 +26,85 @@
 #include "config.h"
 #include "SourceProviderCache.h"
 
+#include "Identifier.h"
+#include <string.h>
+
 namespace JSC {
 
+static const int32_t encodedFormatVersion = 1;
+
+enum EncodedItemFlags {
+    UsesEvalFlag = 1 << 0,
+    StrictModeFlag = 1 << 1,
+    NeedsFullActivationFlag = 1 << 2
+};
+
+static void encodeInt(Vector<char>& buffer, int32_t value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void encodeIdentifiers(Vector<char>& buffer, const Vector<RefPtr<StringImpl> >& identifiers)
+{
+    encodeInt(buffer, identifiers.size());
+    for (size_t i = 0; i < identifiers.size(); ++i) {
+        StringImpl* identifier = identifiers[i].get();
+        encodeInt(buffer, identifier->length());
+        buffer.append(reinterpret_cast<const char*>(identifier->characters()), identifier->length() * sizeof(UChar));
+    }
+}
+
+class SourceProviderCacheDecoder {
+public:
+    SourceProviderCacheDecoder(const char* data, size_t length)
+        : m_position(data)
+        , m_end(data + length)
+    {
+    }
+
+    bool atEnd() const { return m_position == m_end; }
+
+    bool decodeInt(int32_t& value)
+    {
+        if (static_cast<size_t>(m_end - m_position) < sizeof(value))
+            return false;
+        memcpy(&value, m_position, sizeof(value));
+        m_position += sizeof(value);
+        return true;
+    }
+
+    bool decodeIdentifiers(JSGlobalData* globalData, Vector<RefPtr<StringImpl> >& identifiers)
+    {
+        int32_t count;
+        if (!decodeInt(count) || count < 0)
+            return false;
+        // Each identifier takes at least its length and one character, so a
+        // larger count can only come from damaged data; don't let it size the
+        // vector.
+        if (static_cast<size_t>(count) > static_cast<size_t>(m_end - m_position) / (sizeof(int32_t) + sizeof(UChar)))
+            return false;
+        identifiers.reserveInitialCapacity(count);
+        Vector<UChar, 64> characters;
+        for (int32_t i = 0; i < count; ++i) {
+            int32_t length;
+            if (!decodeInt(length) || length <= 0)
+                return false;
+            if (static_cast<size_t>(m_end - m_position) / sizeof(UChar) < static_cast<size_t>(length))
+                return false;
+            // The data need not be aligned for UChar access.
+            characters.resize(length);
+            memcpy(characters.data(), m_position, length * sizeof(UChar));
+            m_position += length * sizeof(UChar);
+            identifiers.uncheckedAppend(Identifier(globalData, characters.data(), length).impl());
+        }
+        return true;
+    }
+
+private:
+    const char* m_position;
+    const char* m_end;
+};
+
 SourceProviderCache::~SourceProviderCache()
 {
     clear();
@@ -50,4 +127,63 @@ void SourceProviderCache::add(int sourcePosition, PassOwnPtr<SourceProviderCache
     m_contentByteSize += size;
 }
 
+void SourceProviderCache::encode(Vector<char>& buffer) const
+{
+    encodeInt(buffer, encodedFormatVersion);
+    encodeInt(buffer, m_map.size());
+    HashMap<int, OwnPtr<SourceProviderCacheItem> >::const_iterator end = m_map.end();
+    for (HashMap<int, OwnPtr<SourceProviderCacheItem> >::const_iterator it = m_map.begin(); it != end; ++it) {
+        const SourceProviderCacheItem* item = it->second.get();
+        encodeInt(buffer, it->first);
+        encodeInt(buffer, item->closeBraceLine);
+        encodeInt(buffer, item->closeBracePos);
+        encodeInt(buffer, (item->usesEval ? UsesEvalFlag : 0) | (item->strictMode ? StrictModeFlag : 0) | (item->needsFullActivation ? NeedsFullActivationFlag : 0));
+        encodeIdentifiers(buffer, item->usedVariables);
+        encodeIdentifiers(buffer, item->writtenVariables);
+    }
+}
+
+bool SourceProviderCache::decode(JSGlobalData* globalData, const char* data, size_t length)
+{
+    ASSERT(m_map.isEmpty());
+
+    SourceProviderCacheDecoder decoder(data, length);
+    int32_t version;
+    int32_t count;
+    if (!decoder.decodeInt(version) || version != encodedFormatVersion)
+        return false;
+    if (!decoder.decodeInt(count) || count < 0)
+        return false;
+
+    for (int32_t i = 0; i < count; ++i) {
+        int32_t sourcePosition;
+        int32_t closeBraceLine;
+        int32_t closeBracePos;
+        int32_t flags;
+        if (!decoder.decodeInt(sourcePosition) || !decoder.decodeInt(closeBraceLine) || !decoder.decodeInt(closeBracePos) || !decoder.decodeInt(flags))
+            break;
+        // Zero and -1 are the empty and deleted keys of the map.
+        if (sourcePosition <= 0 || closeBracePos <= sourcePosition)
+            break;
+
+        OwnPtr<SourceProviderCacheItem> item = adoptPtr(new SourceProviderCacheItem(closeBraceLine, closeBracePos));
+        item->usesEval = flags & UsesEvalFlag;
+        item->strictMode = flags & StrictModeFlag;
+        item->needsFullActivation = flags & NeedsFullActivationFlag;
+        if (!decoder.decodeIdentifiers(globalData, item->usedVariables) || !decoder.decodeIdentifiers(globalData, item->writtenVariables))
+            break;
+
+        unsigned size = item->approximateByteSize();
+        add(sourcePosition, item.release(), size);
+    }
+
+    // Never keep half of a damaged cache: a bogus entry would make the parser
+    // skip to the wrong place.
+    if (m_map.size() != count || !decoder.atEnd()) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
 }
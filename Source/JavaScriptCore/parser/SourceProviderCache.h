@@ -30,12 +30,19 @@
 #include <wtf/HashMap.h>
 #include <wtf/OwnPtr.h>
 #include <wtf/PassOwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefCounted.h>
+#include <wtf/Vector.h>
 
 namespace JSC {
 
-class SourceProviderCache {
+class JSGlobalData;
+
+// Shared by every SourceProvider for the same source text, so that function
+// boundaries found by one parse let later parses of that text skip the bodies.
+class SourceProviderCache : public RefCounted<SourceProviderCache> {
 public:
-    SourceProviderCache() : m_contentByteSize(0) {}
+    static PassRefPtr<SourceProviderCache> create() { return adoptRef(new SourceProviderCache); }
     JS_EXPORT_PRIVATE ~SourceProviderCache();
 
     JS_EXPORT_PRIVATE void clear();
@@ -43,7 +50,15 @@ public:
     void add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem>, unsigned size);
     const SourceProviderCacheItem* get(int sourcePosition) const { return m_map.get(sourcePosition); }
 
+    // Serialization, so that embedders can keep the cache for a source across
+    // process launches. The encoded form is only meaningful for the exact same
+    // source text; decode() rejects data written by another format version.
+    JS_EXPORT_PRIVATE void encode(Vector<char>&) const;
+    JS_EXPORT_PRIVATE bool decode(JSGlobalData*, const char* data, size_t length);
+
 private:
+    SourceProviderCache() : m_contentByteSize(0) {}
+
     HashMap<int, OwnPtr<SourceProviderCacheItem> > m_map;
     unsigned m_contentByteSize;
 };
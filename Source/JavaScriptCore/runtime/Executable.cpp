@@ -95,6 +95,18 @@ static void jettisonCodeBlock(JSGlobalData& globalData, OwnPtr<T>& codeBlock)
     codeBlockToJettison->unlinkIncomingCalls();
     globalData.heap.jettisonDFGCodeBlock(static_pointer_cast<CodeBlock>(codeBlockToJettison.release()));
 }
+
+// Utility method used for installing code blocks that were compiled in the background.
+template<typename T>
+static void installOptimizedCodeBlock(OwnPtr<T>& codeBlock, PassOwnPtr<CodeBlock> optimizedCodeBlock)
+{
+    ASSERT(codeBlock->getJITType() == JITCode::BaselineJIT);
+    ASSERT(optimizedCodeBlock->getJITType() == JITCode::DFGJIT);
+    ASSERT(!optimizedCodeBlock->alternative());
+    OwnPtr<T> codeBlockToInstall = static_pointer_cast<T>(optimizedCodeBlock);
+    codeBlockToInstall->setAlternative(static_pointer_cast<CodeBlock>(codeBlock.release()));
+    codeBlock = codeBlockToInstall.release();
+}
 #endif
 
 void NativeExecutable::finalize(JSCell* cell)
@@ -243,6 +255,14 @@ void EvalExecutable::jettisonOptimizedCode(JSGlobalData& globalData)
     m_jitCodeForCall = m_evalCodeBlock->getJITCode();
     ASSERT(!m_jitCodeForCallWithArityCheck);
 }
+
+void EvalExecutable::installOptimizedCode(PassOwnPtr<CodeBlock> codeBlock)
+{
+    installOptimizedCodeBlock(m_evalCodeBlock, codeBlock);
+    m_jitCodeForCall = m_evalCodeBlock->getJITCode();
+    ASSERT(!m_jitCodeForCallWithArityCheck);
+    Heap::heap(this)->reportExtraMemoryCost(sizeof(*m_evalCodeBlock) + m_jitCodeForCall.size());
+}
 #endif
 
 void EvalExecutable::visitChildren(JSCell* cell, SlotVisitor& visitor)
@@ -369,6 +389,14 @@ void ProgramExecutable::jettisonOptimizedCode(JSGlobalData& globalData)
     m_jitCodeForCall = m_programCodeBlock->getJITCode();
     ASSERT(!m_jitCodeForCallWithArityCheck);
 }
+
+void ProgramExecutable::installOptimizedCode(PassOwnPtr<CodeBlock> codeBlock)
+{
+    installOptimizedCodeBlock(m_programCodeBlock, codeBlock);
+    m_jitCodeForCall = m_programCodeBlock->getJITCode();
+    ASSERT(!m_jitCodeForCallWithArityCheck);
+    Heap::heap(this)->reportExtraMemoryCost(sizeof(*m_programCodeBlock) + m_jitCodeForCall.size());
+}
 #endif
 
 void ProgramExecutable::unlinkCalls()
@@ -586,6 +614,34 @@ void FunctionExecutable::jettisonOptimizedCodeForConstruct(JSGlobalData& globalD
     m_jitCodeForConstruct = m_codeBlockForConstruct->getJITCode();
     m_jitCodeForConstructWithArityCheck = m_codeBlockForConstruct->getJITCodeWithArityCheck();
 }
+
+void FunctionExecutable::installOptimizedCodeForCall(PassOwnPtr<CodeBlock> codeBlock)
+{
+    installOptimizedCodeBlock(m_codeBlockForCall, codeBlock);
+    m_symbolTable = m_codeBlockForCall->sharedSymbolTable();
+    m_jitCodeForCall = m_codeBlockForCall->getJITCode();
+    m_jitCodeForCallWithArityCheck = m_codeBlockForCall->getJITCodeWithArityCheck();
+    Heap::heap(this)->reportExtraMemoryCost(sizeof(*m_codeBlockForCall) + m_jitCodeForCall.size());
+}
+
+void FunctionExecutable::installOptimizedCodeForConstruct(PassOwnPtr<CodeBlock> codeBlock)
+{
+    installOptimizedCodeBlock(m_codeBlockForConstruct, codeBlock);
+    m_symbolTable = m_codeBlockForConstruct->sharedSymbolTable();
+    m_jitCodeForConstruct = m_codeBlockForConstruct->getJITCode();
+    m_jitCodeForConstructWithArityCheck = m_codeBlockForConstruct->getJITCodeWithArityCheck();
+    Heap::heap(this)->reportExtraMemoryCost(sizeof(*m_codeBlockForConstruct) + m_jitCodeForConstruct.size());
+}
+
+void FunctionExecutable::installOptimizedCodeFor(PassOwnPtr<CodeBlock> codeBlock, CodeSpecializationKind kind)
+{
+    if (kind == CodeForCall)
+        installOptimizedCodeForCall(codeBlock);
+    else {
+        ASSERT(kind == CodeForConstruct);
+        installOptimizedCodeForConstruct(codeBlock);
+    }
+}
 #endif
 
 void FunctionExecutable::visitChildren(JSCell* cell, SlotVisitor& visitor)
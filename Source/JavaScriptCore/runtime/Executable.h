@@ -344,6 +344,7 @@ namespace JSC {
         
 #if ENABLE(JIT)
         void jettisonOptimizedCode(JSGlobalData&);
+        void installOptimizedCode(PassOwnPtr<CodeBlock>);
 #endif
 
         EvalCodeBlock& generatedBytecode()
@@ -417,6 +418,7 @@ namespace JSC {
         
 #if ENABLE(JIT)
         void jettisonOptimizedCode(JSGlobalData&);
+        void installOptimizedCode(PassOwnPtr<CodeBlock>);
 #endif
 
         ProgramCodeBlock& generatedBytecode()
@@ -514,6 +516,7 @@ namespace JSC {
         
 #if ENABLE(JIT)
         void jettisonOptimizedCodeForCall(JSGlobalData&);
+        void installOptimizedCodeForCall(PassOwnPtr<CodeBlock>);
 #endif
 
         bool isGeneratedForCall() const
@@ -541,6 +544,7 @@ namespace JSC {
         
 #if ENABLE(JIT)
         void jettisonOptimizedCodeForConstruct(JSGlobalData&);
+        void installOptimizedCodeForConstruct(PassOwnPtr<CodeBlock>);
 #endif
 
         bool isGeneratedForConstruct() const
@@ -588,6 +592,8 @@ namespace JSC {
                 jettisonOptimizedCodeForConstruct(globalData);
             }
         }
+
+        void installOptimizedCodeFor(PassOwnPtr<CodeBlock>, CodeSpecializationKind);
 #endif
         
         bool isGeneratedFor(CodeSpecializationKind kind)
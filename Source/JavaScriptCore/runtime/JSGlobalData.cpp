@@ -32,6 +32,7 @@
 #include "ArgList.h"
 #include "Heap.h"
 #include "CommonIdentifiers.h"
+#include "DFGWorklist.h"
 #include "DebuggerActivation.h"
 #include "FunctionConstructor.h"
 #include "GetterSetter.h"
@@ -49,8 +50,10 @@
 #include "Lexer.h"
 #include "Lookup.h"
 #include "Nodes.h"
+#include "Options.h"
 #include "ParserArena.h"
 #include "RegExpCache.h"
+#include "RegExpCodeCache.h"
 #include "RegExpObject.h"
 #include "StrictEvalActivation.h"
 #include "StrongInlines.h"
@@ -215,6 +218,10 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
 #endif
     jitStubs = adoptPtr(new JITThunks(this));
 #endif
+#if ENABLE(DFG_JIT)
+    if (canUseJIT() && Options::numberOfDFGCompilerThreads)
+        dfgWorklist = DFG::Worklist::create(Options::numberOfDFGCompilerThreads);
+#endif
 
     interpreter->initialize(this->canUseJIT());
 
@@ -437,6 +444,12 @@ void JSGlobalData::recompileAllJSFunctions()
     // If JavaScript is running, it's not safe to recompile, since we'll end
     // up throwing away code that is live on the stack.
     ASSERT(!dynamicGlobalObject);
+
+#if ENABLE(DFG_JIT)
+    // Pending DFG plans would install code for the bytecode we are throwing away.
+    if (dfgWorklist)
+        dfgWorklist->cancelAllPlans();
+#endif
     
     heap.objectSpace().forEachCell<Recompiler>();
 }
@@ -456,6 +469,11 @@ struct StackPreservingRecompiler : public MarkedBlock::VoidFunctor {
 
 void JSGlobalData::releaseExecutableMemory()
 {
+#if ENABLE(DFG_JIT)
+    if (dfgWorklist)
+        dfgWorklist->cancelAllPlans();
+#endif
+
     if (dynamicGlobalObject) {
         StackPreservingRecompiler recompiler;
         HashSet<JSCell*> roots;
@@ -483,6 +501,7 @@ void JSGlobalData::releaseExecutableMemory()
     }
     m_regExpCache->invalidateCode();
     heap.collectAllGarbage();
+    RegExpCodeCache::shared().releaseUnusedCode();
 }
     
 void releaseExecutableMemory(JSGlobalData& globalData)
@@ -503,9 +522,9 @@ void JSGlobalData::dumpRegExpTrace()
     
     if (iter != m_rtTraceList->end()) {
         dataLog("\nRegExp Tracing\n");
-        dataLog("                                                            match()    matches\n");
-        dataLog("Regular Expression                          JIT Address      calls      found\n");
-        dataLog("----------------------------------------+----------------+----------+----------\n");
+        dataLog("                                                            match()    matches    match()\n");
+        dataLog("Regular Expression                          JIT Address      calls      found     interp\n");
+        dataLog("----------------------------------------+----------------+----------+----------+----------\n");
     
         unsigned reCount = 0;
     
@@ -47,6 +47,7 @@
 #include <wtf/HashMap.h>
 #include <wtf/RefCounted.h>
 #include <wtf/ThreadSpecific.h>
+#include <wtf/Threading.h>
 #include <wtf/WTFThreadData.h>
 #if ENABLE(REGEXP_TRACING)
 #include <wtf/ListHashSet.h>
@@ -78,6 +79,12 @@ namespace JSC {
     struct HashTable;
     struct Instruction;
 
+#if ENABLE(DFG_JIT)
+    namespace DFG {
+        class Worklist;
+    }
+#endif
+
     struct DSTOffsetCache {
         DSTOffsetCache()
         {
@@ -252,12 +259,16 @@ namespace JSC {
         void* osrExitJumpDestination;
         Vector<void*> scratchBuffers;
         size_t sizeOfLastScratchBuffer;
+        Mutex scratchBufferLock;
+        OwnPtr<DFG::Worklist> dfgWorklist;
         
+        // Called by code generation, which may run on a DFG compiler thread.
         void* scratchBufferForSize(size_t size)
         {
             if (!size)
                 return 0;
             
+            MutexLocker locker(scratchBufferLock);
             if (size > sizeOfLastScratchBuffer) {
                 // Protect against a N^2 memory usage pathology by ensuring
                 // that at worst, we get a geometric series, meaning that the
@@ -30,10 +30,24 @@
 #include "StringObject.h"
 #include "StringPrototype.h"
 
+using namespace std;
+
 namespace JSC {
     
 static const unsigned substringFromRopeCutoff = 4;
 
+// Reading through a rope gives up and resolves it after walking this many levels.
+// Only the first indexed read walks at all; later ones resolve the rope.
+static const unsigned maxRopeWalkDepth = 32;
+
+// A substring spanning several fibers is copied out if it is at most this long,
+// and otherwise becomes a new rope sharing the fibers it covers.
+static const unsigned maxCopiedRopeSubstringLength = 256;
+
+// find() on a rope keeps the last (target length - 1) characters of each fiber
+// to catch matches spanning fibers; beyond this target length it resolves the rope.
+static const unsigned maxRopeFindTargetLength = 256;
+
 const ClassInfo JSString::s_info = { "string", 0, 0, 0, CREATE_METHOD_TABLE(JSString) };
 
 void JSString::RopeBuilder::expand()
@@ -198,13 +212,233 @@ void JSString::outOfMemory(ExecState* exec) const
 JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
 {
     ASSERT(isRope());
-    resolveRope(exec);
+    UChar c = characterAtSlowCase(exec, i);
     // Return a safe no-value result, this should never be used, since the excetion will be thrown.
     if (exec->exception())
         return jsString(exec, "");
-    ASSERT(!isRope());
-    ASSERT(i < m_value.length());
-    return jsSingleCharacterSubstring(exec, m_value, i);
+    return jsSingleCharacterString(exec, c);
+}
+
+// Visits the non-rope fibers of a rope in order, starting with the one containing
+// a given offset. The fibers are kept alive by the rope, and callers must not
+// allocate GC objects while iterating.
+class RopeIterator {
+public:
+    RopeIterator(JSString* rope, unsigned offset)
+        : m_offset(offset)
+        , m_position(0)
+    {
+        m_workQueue.append(rope);
+    }
+
+    // Returns the next fiber, and sets position to the offset of its first character within the rope.
+    const UString* next(unsigned& position)
+    {
+        while (!m_workQueue.isEmpty()) {
+            JSString* fiber = m_workQueue.last();
+            m_workQueue.removeLast();
+
+            if (m_position + fiber->length() <= m_offset) {
+                m_position += fiber->length();
+                continue;
+            }
+
+            if (fiber->isRope()) {
+                for (size_t i = JSString::s_maxInternalRopeLength; i > 0; --i) {
+                    if (fiber->m_fibers[i - 1])
+                        m_workQueue.append(fiber->m_fibers[i - 1].get());
+                }
+                continue;
+            }
+
+            position = m_position;
+            m_position += fiber->length();
+            return &fiber->m_value;
+        }
+        return 0;
+    }
+
+private:
+    Vector<JSString*, 32> m_workQueue;
+    unsigned m_offset;
+    unsigned m_position;
+};
+
+JSString* JSString::fiberContaining(unsigned& offset) const
+{
+    ASSERT(isRope());
+    ASSERT(offset < m_length);
+    for (size_t i = 0; i < s_maxInternalRopeLength && m_fibers[i]; ++i) {
+        JSString* fiber = m_fibers[i].get();
+        if (offset < fiber->m_length)
+            return fiber;
+        offset -= fiber->m_length;
+    }
+    ASSERT_NOT_REACHED();
+    return 0;
+}
+
+UChar JSString::characterAtSlowCase(ExecState* exec, unsigned i)
+{
+    ASSERT(isRope());
+    ASSERT(i < m_length);
+
+    // A single read is answered by walking the fibers, but a second one suggests
+    // a loop over the characters, which would pay for the walk on every read.
+    if (!m_hasBeenIndexed) {
+        m_hasBeenIndexed = true;
+        unsigned offset = i;
+        JSString* fiber = this;
+        for (unsigned depth = 0; depth < maxRopeWalkDepth; ++depth) {
+            fiber = fiber->fiberContaining(offset);
+            if (!fiber->isRope())
+                return fiber->m_value[offset];
+        }
+    }
+
+    resolveRope(exec);
+    if (exec->hadException())
+        return 0;
+    return m_value[i];
+}
+
+JSString* JSString::substringSlowCase(ExecState* exec, unsigned offset, unsigned length, unsigned depth)
+{
+    ASSERT(isRope());
+    ASSERT(length && offset + length <= m_length);
+    JSGlobalData& globalData = exec->globalData();
+
+    // Descend for as long as the substring lies within a single fiber.
+    JSString* rope = this;
+    while (rope->isRope()) {
+        if (depth++ == maxRopeWalkDepth) {
+            rope->resolveRope(exec);
+            if (exec->hadException())
+                return jsEmptyString(exec);
+            break;
+        }
+        unsigned fiberOffset = offset;
+        JSString* fiber = rope->fiberContaining(fiberOffset);
+        if (fiberOffset + length > fiber->m_length)
+            break;
+        rope = fiber;
+        offset = fiberOffset;
+    }
+
+    if (!rope->isRope())
+        return jsSubstring(&globalData, rope->m_value, offset, length);
+    if (length == rope->m_length)
+        return rope;
+
+    if (length <= maxCopiedRopeSubstringLength) {
+        RopeIterator iterator(rope, offset);
+        unsigned position;
+        if (rope->is8Bit()) {
+            LChar* buffer;
+            RefPtr<StringImpl> impl = StringImpl::createUninitialized(length, buffer);
+            for (unsigned copied = 0; copied < length; ) {
+                StringImpl* string = iterator.next(position)->impl();
+                unsigned start = offset + copied - position;
+                unsigned count = min(string->length() - start, length - copied);
+                StringImpl::copyChars(buffer + copied, string->characters8() + start, count);
+                copied += count;
+            }
+            return JSString::create(globalData, impl.release());
+        }
+        UChar* buffer;
+        RefPtr<StringImpl> impl = StringImpl::createUninitialized(length, buffer);
+        for (unsigned copied = 0; copied < length; ) {
+            StringImpl* string = iterator.next(position)->impl();
+            unsigned start = offset + copied - position;
+            unsigned count = min(string->length() - start, length - copied);
+            if (string->is8Bit()) {
+                const LChar* characters = string->characters8() + start;
+                for (unsigned i = 0; i < count; ++i)
+                    buffer[copied + i] = characters[i];
+            } else
+                StringImpl::copyChars(buffer + copied, string->characters16() + start, count);
+            copied += count;
+        }
+        return JSString::create(globalData, impl.release());
+    }
+
+    // Share the fibers covered by the substring. At most the first and last of them
+    // are only partly covered, and get cut down the same way.
+    RopeBuilder builder(globalData);
+    unsigned end = offset + length;
+    unsigned position = 0;
+    for (size_t i = 0; i < s_maxInternalRopeLength && rope->m_fibers[i]; ++i) {
+        JSString* fiber = rope->m_fibers[i].get();
+        unsigned fiberLength = fiber->m_length;
+        unsigned fiberStart = max(offset, position);
+        unsigned fiberEnd = min(end, position + fiberLength);
+        if (fiberStart < fiberEnd) {
+            if (fiberEnd - fiberStart == fiberLength)
+                builder.append(fiber);
+            else if (fiber->isRope())
+                builder.append(fiber->substringSlowCase(exec, fiberStart - position, fiberEnd - fiberStart, depth));
+            else
+                builder.append(jsSubstring(&globalData, fiber->m_value, fiberStart - position, fiberEnd - fiberStart));
+            if (exec->hadException())
+                return jsEmptyString(exec);
+        }
+        position += fiberLength;
+    }
+    return builder.release();
+}
+
+size_t JSString::findSlowCase(ExecState* exec, const UString& target, unsigned start)
+{
+    ASSERT(isRope());
+    if (target.isNull())
+        return notFound;
+    unsigned targetLength = target.length();
+    if (!targetLength)
+        return min(start, m_length);
+    if (start > m_length || targetLength > m_length - start)
+        return notFound;
+    if (targetLength > maxRopeFindTargetLength) {
+        resolveRope(exec);
+        if (exec->hadException())
+            return notFound;
+        return m_value.find(target, start);
+    }
+
+    // The characters just before the current fiber that a match could start in.
+    Vector<UChar, 64> overlap;
+    RopeIterator iterator(this, start);
+    unsigned position;
+    while (const UString* fiber = iterator.next(position)) {
+        StringImpl* string = fiber->impl();
+        unsigned fiberLength = string->length();
+        unsigned fiberStart = position < start ? start - position : 0;
+
+        if (!overlap.isEmpty()) {
+            unsigned overlapLength = overlap.size();
+            unsigned count = min(fiberLength, targetLength - 1);
+            for (unsigned i = 0; i < count; ++i)
+                overlap.append((*string)[i]);
+            for (unsigned i = 0; i < overlapLength && i + targetLength <= overlap.size(); ++i) {
+                unsigned j = 0;
+                while (j < targetLength && overlap[i + j] == target[j])
+                    ++j;
+                if (j == targetLength)
+                    return position - overlapLength + i;
+            }
+            overlap.shrink(overlapLength);
+        }
+
+        size_t result = string->find(target.impl(), fiberStart);
+        if (result != notFound)
+            return position + result;
+
+        unsigned tailStart = fiberLength > targetLength - 1 ? fiberLength - (targetLength - 1) : 0;
+        for (unsigned i = max(fiberStart, tailStart); i < fiberLength; ++i)
+            overlap.append((*string)[i]);
+        if (overlap.size() > targetLength - 1)
+            overlap.remove(0, overlap.size() - (targetLength - 1));
+    }
+    return notFound;
 }
 
 JSValue JSString::toPrimitive(ExecState*, PreferredPrimitiveType) const
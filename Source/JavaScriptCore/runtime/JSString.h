@@ -63,6 +63,7 @@ namespace JSC {
     public:
         friend class JIT;
         friend class JSGlobalData;
+        friend class RopeIterator;
         friend class SpecializedThunkJIT;
         friend struct ThunkHelpers;
         friend JSString* jsStringBuilder(JSGlobalData*);
@@ -123,6 +124,7 @@ namespace JSC {
             Base::finishCreation(globalData);
             m_length = 0;
             m_is8Bit = true;
+            m_hasBeenIndexed = false;
         }
 
         void finishCreation(JSGlobalData& globalData, size_t length)
@@ -131,6 +133,7 @@ namespace JSC {
             Base::finishCreation(globalData);
             m_length = length;
             m_is8Bit = m_value.impl()->is8Bit();
+            m_hasBeenIndexed = false;
         }
 
         void finishCreation(JSGlobalData& globalData, size_t length, size_t cost)
@@ -139,6 +142,7 @@ namespace JSC {
             Base::finishCreation(globalData);
             m_length = length;
             m_is8Bit = m_value.impl()->is8Bit();
+            m_hasBeenIndexed = false;
             Heap::heap(this)->reportExtraMemoryCost(cost);
         }
 
@@ -147,6 +151,7 @@ namespace JSC {
             Base::finishCreation(globalData);
             m_length = s1->length() + s2->length();
             m_is8Bit = (s1->is8Bit() && s2->is8Bit());
+            m_hasBeenIndexed = false;
             m_fibers[0].set(globalData, this, s1);
             m_fibers[1].set(globalData, this, s2);
         }
@@ -156,6 +161,7 @@ namespace JSC {
             Base::finishCreation(globalData);
             m_length = s1->length() + s2->length() + s3->length();
             m_is8Bit = (s1->is8Bit() && s2->is8Bit() &&  s3->is8Bit());
+            m_hasBeenIndexed = false;
             m_fibers[0].set(globalData, this, s1);
             m_fibers[1].set(globalData, this, s2);
             m_fibers[2].set(globalData, this, s3);
@@ -227,6 +233,11 @@ namespace JSC {
         JSString* getIndex(ExecState*, unsigned);
         JSString* getIndexSlowCase(ExecState*, unsigned);
 
+        // These read a rope through its fibers instead of resolving it, so looking
+        // at a small part of a large concatenated string does not copy all of it.
+        UChar characterAt(ExecState*, unsigned);
+        size_t find(ExecState*, const UString&, unsigned start);
+
         static Structure* createStructure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue proto)
         {
             return Structure::create(globalData, globalObject, proto, TypeInfo(StringType, OverridesGetOwnPropertySlot), &s_info);
@@ -245,6 +256,11 @@ namespace JSC {
         void resolveRopeSlowCase(UChar*) const;
         void outOfMemory(ExecState*) const;
 
+        JSString* fiberContaining(unsigned& offset) const;
+        UChar characterAtSlowCase(ExecState*, unsigned);
+        JSString* substringSlowCase(ExecState*, unsigned offset, unsigned length, unsigned depth = 0);
+        size_t findSlowCase(ExecState*, const UString&, unsigned start);
+
         static JSObject* toThisObject(JSCell*, ExecState*);
 
         // Actually getPropertySlot, not getOwnPropertySlot (see JSCell).
@@ -255,6 +271,8 @@ namespace JSC {
 
         // A string is represented either by a UString or a rope of fibers.
         bool m_is8Bit : 1;
+        // Set once a character has been read out of the rope without resolving it.
+        bool m_hasBeenIndexed : 1;
         unsigned m_length;
         mutable UString m_value;
         mutable FixedArray<WriteBarrier<JSString>, s_maxInternalRopeLength> m_fibers;
@@ -322,6 +340,21 @@ namespace JSC {
         return jsSingleCharacterSubstring(exec, m_value, i);
     }
 
+    inline UChar JSString::characterAt(ExecState* exec, unsigned i)
+    {
+        ASSERT(canGetIndex(i));
+        if (isRope())
+            return characterAtSlowCase(exec, i);
+        return m_value[i];
+    }
+
+    inline size_t JSString::find(ExecState* exec, const UString& target, unsigned start)
+    {
+        if (isRope())
+            return findSlowCase(exec, target, start);
+        return m_value.find(target, start);
+    }
+
     inline JSString* jsString(JSGlobalData* globalData, const UString& s)
     {
         int size = s.length();
@@ -343,7 +376,11 @@ namespace JSC {
         JSGlobalData* globalData = &exec->globalData();
         if (!length)
             return globalData->smallStrings.emptyString(globalData);
-        return jsSubstring(globalData, s->value(exec), offset, length);
+        if (length == s->length())
+            return s;
+        if (s->isRope())
+            return s->substringSlowCase(exec, offset, length);
+        return jsSubstring(globalData, s->string(), offset, length);
     }
 
     inline JSString* jsSubstring8(JSGlobalData* globalData, const UString& s, unsigned offset, unsigned length)
@@ -123,43 +123,77 @@ bool LiteralParser<CharType>::tryJSONPParse(Vector<JSONPData>& results, bool nee
 }
     
 template <typename CharType>
-ALWAYS_INLINE const Identifier LiteralParser<CharType>::makeIdentifier(const LChar* characters, size_t length)
+template <typename IdentifierCharType>
+ALWAYS_INLINE const Identifier LiteralParser<CharType>::makeIdentifier(const IdentifierCharType* characters, size_t length)
 {
     if (!length)
         return m_exec->globalData().propertyNames->emptyIdentifier;
-    if (characters[0] >= MaximumCachableCharacter)
-        return Identifier(&m_exec->globalData(), characters, length);
 
     if (length == 1) {
+        if (characters[0] >= MaximumCachableCharacter)
+            return Identifier(&m_exec->globalData(), characters, length);
         if (!m_shortIdentifiers[characters[0]].isNull())
             return m_shortIdentifiers[characters[0]];
         m_shortIdentifiers[characters[0]] = Identifier(&m_exec->globalData(), characters, length);
         return m_shortIdentifiers[characters[0]];
     }
-    if (!m_recentIdentifiers[characters[0]].isNull() && Identifier::equal(m_recentIdentifiers[characters[0]].impl(), characters, length))
-        return m_recentIdentifiers[characters[0]];
-    m_recentIdentifiers[characters[0]] = Identifier(&m_exec->globalData(), characters, length);
-    return m_recentIdentifiers[characters[0]];
+
+    // Property names in JSON tend to repeat, and many share a first character,
+    // so the cache slot depends on the length and last character as well.
+    Identifier& recentIdentifier = m_recentIdentifiers[(characters[0] + characters[length - 1] * 7 + length * 31) % RecentIdentifierCacheSize];
+    if (!recentIdentifier.isNull() && Identifier::equal(recentIdentifier.impl(), characters, length))
+        return recentIdentifier;
+    recentIdentifier = Identifier(&m_exec->globalData(), characters, length);
+    return recentIdentifier;
 }
 
 template <typename CharType>
-ALWAYS_INLINE const Identifier LiteralParser<CharType>::makeIdentifier(const UChar* characters, size_t length)
+bool LiteralParser<CharType>::cacheObjectShape(ObjectShape& shape, Structure* initialStructure, const Identifier* propertyNames, unsigned count)
 {
-    if (!length)
-        return m_exec->globalData().propertyNames->emptyIdentifier;
-    if (characters[0] >= MaximumCachableCharacter)
-        return Identifier(&m_exec->globalData(), characters, length);
+    Vector<size_t> offsets(count);
+    Structure* structure = initialStructure;
+    for (unsigned i = 0; i < count; ++i) {
+        if (structure->isDictionary())
+            return false;
+        structure = Structure::addPropertyTransitionToExistingStructure(structure, propertyNames[i], 0, 0, offsets[i]);
+        if (!structure)
+            return false;
+    }
 
-    if (length == 1) {
-        if (!m_shortIdentifiers[characters[0]].isNull())
-            return m_shortIdentifiers[characters[0]];
-        m_shortIdentifiers[characters[0]] = Identifier(&m_exec->globalData(), characters, length);
-        return m_shortIdentifiers[characters[0]];
+    JSGlobalData& globalData = m_exec->globalData();
+    shape.m_initialStructure.set(globalData, initialStructure);
+    shape.m_structure.set(globalData, structure);
+    shape.m_propertyNames.clear();
+    shape.m_propertyNames.append(propertyNames, count);
+    shape.m_offsets.swap(offsets);
+    return true;
+}
+
+// Properties are added once an object is complete, so that an object laid out like
+// one seen before can go straight to its final Structure and size its property
+// storage once, rather than taking a transition and growing storage per property.
+template <typename CharType>
+void LiteralParser<CharType>::putObjectProperties(JSObject* object, const Identifier* propertyNames, MarkedArgumentBuffer& values, unsigned count)
+{
+    JSGlobalData& globalData = m_exec->globalData();
+    unsigned firstValue = values.size() - count;
+    Structure* initialStructure = object->structure();
+
+    ObjectShape& shape = m_objectShapes[(propertyNames[0].impl()->hash() + count) % ObjectShapeCacheSize];
+    bool shapeMatches = shape.m_initialStructure.get() == initialStructure && shape.m_propertyNames.size() == count;
+    for (unsigned i = 0; shapeMatches && i < count; ++i)
+        shapeMatches = shape.m_propertyNames[i].impl() == propertyNames[i].impl();
+
+    if (!shapeMatches && !cacheObjectShape(shape, initialStructure, propertyNames, count)) {
+        // Either the keys repeat, or this layout has not been built before.
+        for (unsigned i = 0; i < count; ++i)
+            object->putDirect(globalData, propertyNames[i], values.at(firstValue + i));
+        return;
     }
-    if (!m_recentIdentifiers[characters[0]].isNull() && Identifier::equal(m_recentIdentifiers[characters[0]].impl(), characters, length))
-        return m_recentIdentifiers[characters[0]];
-    m_recentIdentifiers[characters[0]] = Identifier(&m_exec->globalData(), characters, length);
-    return m_recentIdentifiers[characters[0]];
+
+    object->transitionTo(globalData, shape.m_structure.get());
+    for (unsigned i = 0; i < count; ++i)
+        object->putDirectOffset(globalData, shape.m_offsets[i], values.at(firstValue + i));
 }
 
 template <typename CharType>
@@ -549,6 +583,8 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
     JSValue lastValue;
     Vector<ParserState, 16> stateStack;
     Vector<Identifier, 16> identifierStack;
+    MarkedArgumentBuffer propertyValueStack;
+    Vector<unsigned, 16> objectPropertiesStartStack;
     while (1) {
         switch(state) {
             startParseArray:
@@ -594,6 +630,7 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
             case StartParseObject: {
                 JSObject* object = constructEmptyObject(m_exec);
                 objectStack.append(object);
+                objectPropertiesStartStack.append(identifierStack.size());
 
                 TokenType type = m_lexer.next();
                 if (type == TokString || (m_mode != StrictJSON && type == TokIdentifier)) {
@@ -618,6 +655,7 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                     return JSValue();
                 }
                 m_lexer.next();
+                objectPropertiesStartStack.removeLast();
                 lastValue = objectStack.last();
                 objectStack.removeLast();
                 break;
@@ -647,8 +685,7 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
             }
             case DoParseObjectEndExpression:
             {
-                asObject(objectStack.last())->putDirect(m_exec->globalData(), identifierStack.last(), lastValue);
-                identifierStack.removeLast();
+                propertyValueStack.append(lastValue);
                 if (m_lexer.currentToken().type == TokComma)
                     goto doParseObjectStartExpression;
                 if (m_lexer.currentToken().type != TokRBrace) {
@@ -656,6 +693,15 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                     return JSValue();
                 }
                 m_lexer.next();
+
+                unsigned propertiesStart = objectPropertiesStartStack.last();
+                unsigned propertyCount = identifierStack.size() - propertiesStart;
+                putObjectProperties(asObject(objectStack.last()), identifierStack.data() + propertiesStart, propertyValueStack, propertyCount);
+                identifierStack.shrink(propertiesStart);
+                for (unsigned i = 0; i < propertyCount; ++i)
+                    propertyValueStack.removeLast();
+                objectPropertiesStartStack.removeLast();
+
                 lastValue = objectStack.last();
                 objectStack.removeLast();
                 break;
@@ -150,15 +150,30 @@ private:
     class StackGuard;
     JSValue parse(ParserState);
 
+    // The layout of an object built earlier in this parse: its property names in
+    // order, the Structure they lead to from the Structure of an empty object, and
+    // the offset of each property in it.
+    struct ObjectShape {
+        Strong<Structure> m_initialStructure;
+        Strong<Structure> m_structure;
+        Vector<Identifier> m_propertyNames;
+        Vector<size_t> m_offsets;
+    };
+
+    void putObjectProperties(JSObject*, const Identifier* propertyNames, MarkedArgumentBuffer& values, unsigned count);
+    bool cacheObjectShape(ObjectShape&, Structure*, const Identifier* propertyNames, unsigned count);
+
     ExecState* m_exec;
     typename LiteralParser<CharType>::Lexer m_lexer;
     ParserMode m_mode;
     UString m_parseErrorMessage;
     static unsigned const MaximumCachableCharacter = 128;
+    static unsigned const RecentIdentifierCacheSize = 256;
+    static unsigned const ObjectShapeCacheSize = 16;
     FixedArray<Identifier, MaximumCachableCharacter> m_shortIdentifiers;
-    FixedArray<Identifier, MaximumCachableCharacter> m_recentIdentifiers;
-    ALWAYS_INLINE const Identifier makeIdentifier(const LChar* characters, size_t length);
-    ALWAYS_INLINE const Identifier makeIdentifier(const UChar* characters, size_t length);
+    FixedArray<Identifier, RecentIdentifierCacheSize> m_recentIdentifiers;
+    FixedArray<ObjectShape, ObjectShapeCacheSize> m_objectShapes;
+    template <typename IdentifierCharType> ALWAYS_INLINE const Identifier makeIdentifier(const IdentifierCharType* characters, size_t length);
     };
 
 }
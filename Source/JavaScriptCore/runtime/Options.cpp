@@ -83,6 +83,8 @@ double desiredProfileFullnessRate;
 
 double doubleVoteRatioForDoubleFormat;
 
+unsigned numberOfDFGCompilerThreads;
+
 unsigned minimumNumberOfScansBetweenRebalance;
 unsigned gcMarkStackSegmentSize;
 unsigned minimumNumberOfCellsToKeep;
@@ -166,6 +168,10 @@ void initializeOptions()
     SET(desiredProfileFullnessRate, 0.35);
     
     SET(doubleVoteRatioForDoubleFormat, 2);
+
+    // Only move optimizing compilation off the main thread if there is a spare
+    // core for it to move to.
+    SET(numberOfDFGCompilerThreads, WTF::numberOfProcessorCores() > 1 ? 1 : 0);
     
     SET(minimumNumberOfScansBetweenRebalance, 10000);
     SET(gcMarkStackSegmentSize,               pageSize());
@@ -68,6 +68,8 @@ extern double desiredProfileFullnessRate;
 
 extern double doubleVoteRatioForDoubleFormat;
 
+extern unsigned numberOfDFGCompilerThreads; // Zero compiles on the main thread.
+
 extern unsigned minimumNumberOfScansBetweenRebalance;
 extern unsigned gcMarkStackSegmentSize;
 extern unsigned minimumNumberOfCellsToKeep;
@@ -25,6 +25,7 @@
 
 #include "Lexer.h"
 #include "RegExpCache.h"
+#include "RegExpCodeCache.h"
 #include "yarr/Yarr.h"
 #include "yarr/YarrJIT.h"
 #include <stdio.h>
@@ -217,13 +218,6 @@ void RegExpFunctionalTestCollector::outputEscapedUString(const UString& s, bool
 }
 #endif
 
-struct RegExpRepresentation {
-#if ENABLE(YARR_JIT)
-    Yarr::YarrCodeBlock m_regExpJITCode;
-#endif
-    OwnPtr<Yarr::BytecodePattern> m_regExpBytecode;
-};
-
 RegExp::RegExp(JSGlobalData& globalData, const UString& patternString, RegExpFlags flags)
     : JSCell(globalData, globalData.regExpStructure.get())
     , m_state(NotCompiled)
@@ -231,9 +225,12 @@ RegExp::RegExp(JSGlobalData& globalData, const UString& patternString, RegExpFla
     , m_flags(flags)
     , m_constructionError(0)
     , m_numSubpatterns(0)
+    , m_hasJIT8BitCode(false)
+    , m_hasJIT16BitCode(false)
 #if ENABLE(REGEXP_TRACING)
     , m_rtMatchCallCount(0)
     , m_rtMatchFoundCount(0)
+    , m_rtInterpretedMatchCount(0)
 #endif
 {
 }
@@ -271,60 +268,37 @@ RegExp* RegExp::create(JSGlobalData& globalData, const UString& patternString, R
 
 void RegExp::compile(JSGlobalData* globalData, Yarr::YarrCharSize charSize)
 {
-    Yarr::YarrPattern pattern(m_patternString, ignoreCase(), multiline(), &m_constructionError);
-    if (m_constructionError) {
-        ASSERT_NOT_REACHED();
-        m_state = ParseError;
-        return;
-    }
-    ASSERT(m_numSubpatterns == pattern.m_numSubpatterns);
-
-    if (!m_representation) {
+    if (!m_code) {
         ASSERT(m_state == NotCompiled);
-        m_representation = adoptPtr(new RegExpRepresentation);
+        m_code = RegExpCodeCache::shared().lookupOrCreate(m_patternString, m_flags);
         globalData->regExpCache()->addToStrongCache(this);
-        m_state = ByteCode;
     }
 
-#if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && globalData->canUseJIT()) {
-        Yarr::jitCompile(pattern, charSize, globalData, m_representation->m_regExpJITCode);
-#if ENABLE(YARR_JIT_DEBUG)
-        if (!m_representation->m_regExpJITCode.isFallBack())
-            m_state = JITCode;
-        else
-            m_state = ByteCode;
-#else
-        if (!m_representation->m_regExpJITCode.isFallBack()) {
-            m_state = JITCode;
-            return;
-        }
-#endif
+    if (!m_code->compile(globalData, charSize)) {
+        m_state = ByteCode;
+        return;
     }
-#else
-    UNUSED_PARAM(charSize);
-#endif
 
-    m_representation->m_regExpBytecode = Yarr::byteCompile(pattern, &globalData->m_regExpAllocator);
+    m_state = JITCode;
+    if (charSize == Yarr::Char8)
+        m_hasJIT8BitCode = true;
+    else
+        m_hasJIT16BitCode = true;
 }
 
 void RegExp::compileIfNecessary(JSGlobalData& globalData, Yarr::YarrCharSize charSize)
 {
-    // If the state is NotCompiled or ParseError, then there is no representation.
-    // If there is a representation, and the state must be either JITCode or ByteCode.
-    ASSERT(!!m_representation == (m_state == JITCode || m_state == ByteCode));
+    // If the state is NotCompiled or ParseError, then there is no code.
+    // If there is code, the state must be either JITCode or ByteCode.
+    ASSERT(!!m_code == (m_state == JITCode || m_state == ByteCode));
     
-    if (m_representation) {
-#if ENABLE(YARR_JIT)
+    if (m_code) {
         if (m_state != JITCode)
             return;
-        if ((charSize == Yarr::Char8) && (m_representation->m_regExpJITCode.has8BitCode()))
+        if ((charSize == Yarr::Char8) && m_hasJIT8BitCode)
             return;
-        if ((charSize == Yarr::Char16) && (m_representation->m_regExpJITCode.has16BitCode()))
+        if ((charSize == Yarr::Char16) && m_hasJIT16BitCode)
             return;
-#else
-        return;
-#endif
     }
 
     compile(&globalData, charSize);
@@ -355,15 +329,20 @@ int RegExp::match(JSGlobalData& globalData, const UString& s, unsigned startOffs
 #if ENABLE(YARR_JIT)
     if (m_state == JITCode) {
         if (s.is8Bit())
-            result = Yarr::execute(m_representation->m_regExpJITCode, s.characters8(), startOffset, s.length(), offsetVector);
+            result = Yarr::execute(m_code->jitCode(), s.characters8(), startOffset, s.length(), offsetVector);
         else
-            result = Yarr::execute(m_representation->m_regExpJITCode, s.characters16(), startOffset, s.length(), offsetVector);
+            result = Yarr::execute(m_code->jitCode(), s.characters16(), startOffset, s.length(), offsetVector);
 #if ENABLE(YARR_JIT_DEBUG)
-        matchCompareWithInterpreter(s, startOffset, offsetVector, result);
+        matchCompareWithInterpreter(globalData, s, startOffset, offsetVector, result);
 #endif
     } else
 #endif
-        result = Yarr::interpret(m_representation->m_regExpBytecode.get(), s, startOffset, s.length(), offsetVector);
+    {
+#if ENABLE(REGEXP_TRACING)
+        m_rtInterpretedMatchCount++;
+#endif
+        result = Yarr::interpret(m_code->bytecode(), &globalData.m_regExpAllocator, s, startOffset, s.length(), offsetVector);
+    }
     ASSERT(result >= -1);
 
 #if REGEXP_FUNC_TEST_DATA_GEN
@@ -380,14 +359,16 @@ int RegExp::match(JSGlobalData& globalData, const UString& s, unsigned startOffs
 
 void RegExp::invalidateCode()
 {
-    if (!m_representation)
+    if (!m_code)
         return;
     m_state = NotCompiled;
-    m_representation.clear();
+    m_hasJIT8BitCode = false;
+    m_hasJIT16BitCode = false;
+    m_code.clear();
 }
 
 #if ENABLE(YARR_JIT_DEBUG)
-void RegExp::matchCompareWithInterpreter(const UString& s, int startOffset, int* offsetVector, int jitResult)
+void RegExp::matchCompareWithInterpreter(JSGlobalData& globalData, const UString& s, int startOffset, int* offsetVector, int jitResult)
 {
     int offsetVectorSize = (m_numSubpatterns + 1) * 2;
     Vector<int, 32> interpreterOvector;
@@ -402,7 +383,7 @@ void RegExp::matchCompareWithInterpreter(const UString& s, int startOffset, int*
     for (unsigned j = 0, i = 0; i < m_numSubpatterns + 1; j += 2, i++)
         interpreterOffsetVector[j] = -1;
 
-    interpreterResult = Yarr::interpret(m_representation->m_regExpBytecode.get(), s, startOffset, s.length(), interpreterOffsetVector);
+    interpreterResult = Yarr::interpret(m_code->bytecode(), &globalData.m_regExpAllocator, s, startOffset, s.length(), interpreterOffsetVector);
 
     if (jitResult != interpreterResult)
         differences++;
@@ -451,19 +432,17 @@ void RegExp::matchCompareWithInterpreter(const UString& s, int startOffset, int*
         snprintf(formattedPattern, 41, (pattLen <= 38) ? "/%.38s/" : "/%.36s...", rawPattern);
 
 #if ENABLE(YARR_JIT)
-        Yarr::YarrCodeBlock& codeBlock = m_representation->m_regExpJITCode;
-
         const size_t jitAddrSize = 20;
         char jitAddr[jitAddrSize];
-        if (m_state == JITCode)
+        if (m_state != JITCode)
             snprintf(jitAddr, jitAddrSize, "fallback");
         else
-            snprintf(jitAddr, jitAddrSize, "0x%014lx", reinterpret_cast<unsigned long int>(codeBlock.getAddr()));
+            snprintf(jitAddr, jitAddrSize, "0x%014lx", reinterpret_cast<unsigned long int>(m_code->jitCode().getAddr()));
 #else
         const char* jitAddr = "JIT Off";
 #endif
 
-        printf("%-40.40s %16.16s %10d %10d\n", formattedPattern, jitAddr, m_rtMatchCallCount, m_rtMatchFoundCount);
+        printf("%-40.40s %16.16s %10d %10d %10d\n", formattedPattern, jitAddr, m_rtMatchCallCount, m_rtMatchFoundCount, m_rtInterpretedMatchCount);
     }
 #endif
 
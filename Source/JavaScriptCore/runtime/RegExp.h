@@ -29,11 +29,12 @@
 #include "yarr/Yarr.h"
 #include <wtf/Forward.h>
 #include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
 
 namespace JSC {
 
-    struct RegExpRepresentation;
     class JSGlobalData;
+    class RegExpCode;
 
     JS_EXPORT_PRIVATE RegExpFlags regExpFlags(const UString&);
 
@@ -58,7 +59,7 @@ namespace JSC {
 
         bool hasCode()
         {
-            return m_representation;
+            return m_code;
         }
 
         void invalidateCode();
@@ -96,7 +97,7 @@ namespace JSC {
         void compileIfNecessary(JSGlobalData&, Yarr::YarrCharSize);
 
 #if ENABLE(YARR_JIT_DEBUG)
-        void matchCompareWithInterpreter(const UString&, int startOffset, int* offsetVector, int jitResult);
+        void matchCompareWithInterpreter(JSGlobalData&, const UString&, int startOffset, int* offsetVector, int jitResult);
 #endif
 
         UString m_patternString;
@@ -106,9 +107,15 @@ namespace JSC {
 #if ENABLE(REGEXP_TRACING)
         unsigned m_rtMatchCallCount;
         unsigned m_rtMatchFoundCount;
+        unsigned m_rtInterpretedMatchCount;
 #endif
 
-        OwnPtr<RegExpRepresentation> m_representation;
+        // Shared with every other RegExp in the process with the same pattern and
+        // flags, see RegExpCodeCache. m_hasJIT8BitCode and m_hasJIT16BitCode record
+        // which JIT code this RegExp has already asked m_code for.
+        RefPtr<RegExpCode> m_code;
+        bool m_hasJIT8BitCode;
+        bool m_hasJIT16BitCode;
     };
 
 } // namespace JSC
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "RegExpCodeCache.h"
+
+#include "JSGlobalData.h"
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+RegExpCode::RegExpCode(const UString& pattern, RegExpFlags flags)
+    : m_pattern(pattern.impl()->isolatedCopy())
+    , m_flags(flags)
+{
+}
+
+bool RegExpCode::compile(JSGlobalData* globalData, Yarr::YarrCharSize charSize)
+{
+    MutexLocker locker(m_lock);
+
+#if ENABLE(YARR_JIT)
+    if (globalData->canUseJIT() && !m_jitCode.isFallBack()) {
+        if (charSize == Yarr::Char8 ? !m_jitCode.has8BitCode() : !m_jitCode.has16BitCode()) {
+            const char* error = 0;
+            Yarr::YarrPattern pattern(m_pattern, m_flags & FlagIgnoreCase, m_flags & FlagMultiline, &error);
+            ASSERT(!error);
+            Yarr::jitCompile(pattern, charSize, globalData, m_jitCode);
+        }
+#if ENABLE(YARR_JIT_DEBUG)
+        // RegExp::matchCompareWithInterpreter checks every JIT result against the interpreter.
+        compileBytecode();
+#endif
+        if (!m_jitCode.isFallBack())
+            return true;
+    }
+#else
+    UNUSED_PARAM(globalData);
+    UNUSED_PARAM(charSize);
+#endif
+
+    compileBytecode();
+    return false;
+}
+
+void RegExpCode::compileBytecode()
+{
+    if (m_bytecode)
+        return;
+
+    const char* error = 0;
+    Yarr::YarrPattern pattern(m_pattern, m_flags & FlagIgnoreCase, m_flags & FlagMultiline, &error);
+    ASSERT(!error);
+    // The bytecode may be run by several threads at once, so it does not own an
+    // allocator; each RegExp passes in that of its JSGlobalData.
+    m_bytecode = Yarr::byteCompile(pattern, 0);
+}
+
+RegExpCodeCache& RegExpCodeCache::shared()
+{
+    AtomicallyInitializedStatic(RegExpCodeCache&, cache = *new RegExpCodeCache);
+    return cache;
+}
+
+PassRefPtr<RegExpCode> RegExpCodeCache::lookupOrCreate(const UString& pattern, RegExpFlags flags)
+{
+    // The compiled code does not depend on whether the expression is global.
+    flags = static_cast<RegExpFlags>(flags & ~FlagGlobal);
+
+    if (pattern.length() > maxCacheablePatternLength)
+        return RegExpCode::create(pattern, flags);
+
+    MutexLocker locker(m_lock);
+
+    CodeMap::iterator it = m_code.find(RegExpKey(flags, pattern));
+    if (it != m_code.end()) {
+        RegExpKey key = it->first;
+        m_useOrder.remove(key);
+        m_useOrder.add(key);
+        return it->second;
+    }
+
+    RefPtr<RegExpCode> code = RegExpCode::create(pattern, flags);
+    RegExpKey key(flags, pattern.impl()->isolatedCopy());
+    m_code.set(key, code);
+    m_useOrder.add(key);
+
+    if (m_code.size() > maxEntries)
+        evictUnusedEntries(maxEntries);
+
+    return code.release();
+}
+
+void RegExpCodeCache::releaseUnusedCode()
+{
+    MutexLocker locker(m_lock);
+    evictUnusedEntries(0);
+}
+
+void RegExpCodeCache::evictUnusedEntries(size_t maxSize)
+{
+    // Code still held by a RegExp is kept, since dropping it from the table
+    // would only lead to a second copy being compiled.
+    Vector<RegExpKey> unusedKeys;
+    size_t size = m_code.size();
+    ListHashSet<RegExpKey>::iterator end = m_useOrder.end();
+    for (ListHashSet<RegExpKey>::iterator it = m_useOrder.begin(); it != end && size > maxSize; ++it) {
+        if (!m_code.find(*it)->second->hasOneRef())
+            continue;
+        unusedKeys.append(*it);
+        --size;
+    }
+
+    for (size_t i = 0; i < unusedKeys.size(); ++i) {
+        m_useOrder.remove(unusedKeys[i]);
+        m_code.remove(unusedKeys[i]);
+    }
+}
+
+} // namespace JSC
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RegExpCodeCache_h
+#define RegExpCodeCache_h
+
+#include "RegExpKey.h"
+#include "UString.h"
+#include "yarr/Yarr.h"
+#include "yarr/YarrInterpreter.h"
+#include "yarr/YarrJIT.h"
+#include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/Threading.h>
+
+namespace JSC {
+
+class JSGlobalData;
+
+// The compiled form of a regular expression. One of these is shared by every
+// RegExp in the process with the same pattern and flags, whichever JSGlobalData
+// the RegExp belongs to, so it is only ever compiled while holding its lock.
+class RegExpCode : public ThreadSafeRefCounted<RegExpCode> {
+public:
+    static PassRefPtr<RegExpCode> create(const UString& pattern, RegExpFlags flags)
+    {
+        return adoptRef(new RegExpCode(pattern, flags));
+    }
+
+    // Makes sure there is code to match strings of the given character size.
+    // Returns true if that is JIT code, false if the bytecode must be interpreted.
+    bool compile(JSGlobalData*, Yarr::YarrCharSize);
+
+#if ENABLE(YARR_JIT)
+    // Only valid for a character size that compile() returned true for.
+    Yarr::YarrCodeBlock& jitCode() { return m_jitCode; }
+#endif
+    // Only valid once compile() has returned false, or in YARR_JIT_DEBUG builds.
+    Yarr::BytecodePattern* bytecode() { return m_bytecode.get(); }
+
+private:
+    RegExpCode(const UString& pattern, RegExpFlags);
+
+    void compileBytecode();
+
+    UString m_pattern;
+    RegExpFlags m_flags;
+    Mutex m_lock;
+#if ENABLE(YARR_JIT)
+    Yarr::YarrCodeBlock m_jitCode;
+#endif
+    OwnPtr<Yarr::BytecodePattern> m_bytecode;
+};
+
+// Process-wide table of RegExpCode, so that the workers of a page do not each
+// compile the same regular expressions again. Entries stay in the table after
+// their last RegExp goes away, and are evicted least recently used first once
+// the table grows past maxEntries.
+class RegExpCodeCache {
+    WTF_MAKE_NONCOPYABLE(RegExpCodeCache); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static RegExpCodeCache& shared();
+
+    PassRefPtr<RegExpCode> lookupOrCreate(const UString& pattern, RegExpFlags);
+
+    // Drops all code that no RegExp is using.
+    void releaseUnusedCode();
+
+private:
+    RegExpCodeCache() { }
+
+    static const unsigned maxCacheablePatternLength = 1024;
+    static const size_t maxEntries = 256;
+
+    void evictUnusedEntries(size_t maxSize);
+
+    typedef HashMap<RegExpKey, RefPtr<RegExpCode> > CodeMap;
+
+    Mutex m_lock;
+    CodeMap m_code;
+    ListHashSet<RegExpKey> m_useOrder; // Least recently used first.
+};
+
+} // namespace JSC
+
+#endif // RegExpCodeCache_h
@@ -1025,6 +1025,12 @@
 #define ENABLE_ASSEMBLER 1
 #endif
 
+/* CSS Selector JIT - compiles hot style rule selectors in WebCore to native code.
+   Only the x86-64 System V calling convention is implemented so far. */
+#if !defined(ENABLE_CSS_SELECTOR_JIT) && ENABLE(JIT) && CPU(X86_64) && !OS(WINDOWS)
+#define ENABLE_CSS_SELECTOR_JIT 1
+#endif
+
 /* Pick which allocator to use; we only need an executable allocator if the assembler is compiled in.
    On x86-64 we use a single fixed mmap, on other platforms we mmap on demand. */
 #if ENABLE(ASSEMBLER)
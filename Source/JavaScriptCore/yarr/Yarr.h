@@ -64,6 +64,7 @@ enum YarrCharSize {
 
 JS_EXPORT_PRIVATE PassOwnPtr<BytecodePattern> byteCompile(YarrPattern&, BumpPointerAllocator*);
 JS_EXPORT_PRIVATE int interpret(BytecodePattern*, const UString& input, unsigned start, unsigned length, int* output);
+JS_EXPORT_PRIVATE int interpret(BytecodePattern*, BumpPointerAllocator*, const UString& input, unsigned start, unsigned length, int* output);
 
 } } // namespace JSC::Yarr
 
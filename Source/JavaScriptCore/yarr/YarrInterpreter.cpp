@@ -1457,7 +1457,7 @@ public:
         for (unsigned i = 0; i < pattern->m_body->m_numSubpatterns + 1; ++i)
             output[i << 1] = -1;
 
-        allocatorPool = pattern->m_allocator->startAllocator();
+        allocatorPool = allocator->startAllocator();
         if (!allocatorPool)
             CRASH();
 
@@ -1471,14 +1471,15 @@ public:
 
         freeDisjunctionContext(context);
 
-        pattern->m_allocator->stopAllocator();
+        allocator->stopAllocator();
 
         ASSERT((result == JSRegExpMatch) == (output[0] != -1));
         return output[0];
     }
 
-    Interpreter(BytecodePattern* pattern, int* output, const UString input, unsigned start, unsigned length)
+    Interpreter(BytecodePattern* pattern, BumpPointerAllocator* allocator, int* output, const UString input, unsigned start, unsigned length)
         : pattern(pattern)
+        , allocator(allocator)
         , output(output)
         , input(input, start, length)
         , allocatorPool(0)
@@ -1488,6 +1489,7 @@ public:
 
 private:
     BytecodePattern* pattern;
+    BumpPointerAllocator* allocator;
     int* output;
     InputStream input;
     BumpPointerPool* allocatorPool;
@@ -1969,7 +1971,12 @@ PassOwnPtr<BytecodePattern> byteCompile(YarrPattern& pattern, BumpPointerAllocat
 
 int interpret(BytecodePattern* bytecode, const UString& input, unsigned start, unsigned length, int* output)
 {
-    return Interpreter(bytecode, output, input, start, length).interpret();
+    return interpret(bytecode, bytecode->m_allocator, input, start, length, output);
+}
+
+int interpret(BytecodePattern* bytecode, BumpPointerAllocator* allocator, const UString& input, unsigned start, unsigned length, int* output)
+{
+    return Interpreter(bytecode, allocator, output, input, start, length).interpret();
 }
 
 COMPILE_ASSERT(sizeof(Interpreter::BackTrackInfoPatternCharacter) == (YarrStackSpaceForBackTrackInfoPatternCharacter * sizeof(uintptr_t)), CheckYarrStackSpaceForBackTrackInfoPatternCharacter);
@@ -363,8 +363,8 @@ public:
     OwnPtr<ByteDisjunction> m_body;
     bool m_ignoreCase;
     bool m_multiline;
-    // Each BytecodePattern is associated with a RegExp, each RegExp is associated
-    // with a JSGlobalData.  Cache a pointer to out JSGlobalData's m_regExpAllocator.
+    // The allocator used by interpret() when the caller does not supply one. This is
+    // null for bytecode shared between JSGlobalDatas, see RegExpCodeCache.
     BumpPointerAllocator* m_allocator;
 
     CharacterClass* newlineCharacterClass;
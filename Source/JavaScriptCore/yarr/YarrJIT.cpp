@@ -271,12 +271,12 @@ class YarrGenerator : private MacroAssembler {
         return branch32(NotEqual, character, Imm32(ch));
     }
 
-    void readCharacter(int inputPosition, RegisterID reg)
+    void readCharacter(int inputPosition, RegisterID reg, RegisterID indexReg = index)
     {
         if (m_charSize == Char8)
-            load8(BaseIndex(input, index, TimesOne, inputPosition * sizeof(char)), reg);
+            load8(BaseIndex(input, indexReg, TimesOne, inputPosition * sizeof(char)), reg);
         else
-            load16(BaseIndex(input, index, TimesTwo, inputPosition * sizeof(UChar)), reg);
+            load16(BaseIndex(input, indexReg, TimesTwo, inputPosition * sizeof(UChar)), reg);
     }
 
     void storeToFrame(RegisterID reg, unsigned frameLocation)
@@ -1062,6 +1062,256 @@ class YarrGenerator : private MacroAssembler {
         m_backtrackingState.fallthrough();
     }
 
+    void matchRequiredPrefix(int inputPosition, JumpList& failures)
+    {
+        for (unsigned i = 0; i < m_requiredPrefixLength; ++i)
+            failures.append(jumpIfCharNotEquals(m_requiredPrefix[i], inputPosition + i, regT0));
+    }
+
+#if CPU(X86) || CPU(X86_64)
+    static const XMMRegisterID packedInput = X86Registers::xmm0;
+    static const XMMRegisterID packedNextInput = X86Registers::xmm1;
+    static const XMMRegisterID packedCaseMask = X86Registers::xmm2;
+    static const XMMRegisterID packedPrefixCharacter = X86Registers::xmm3;
+    static const XMMRegisterID packedNextPrefixCharacter = X86Registers::xmm4;
+
+    // Computed unsigned; a character at or above 0x80 (or 0x8000) would overflow int.
+    unsigned splatCharacter(UChar ch)
+    {
+        return m_charSize == Char8 ? ch * 0x01010101u : ch * 0x00010001u;
+    }
+
+    bool prefixCharacterIgnoresCase(unsigned i)
+    {
+        return m_pattern.m_ignoreCase && isASCIIAlpha(m_requiredPrefix[i]);
+    }
+
+    // Loads the prefix characters into vector registers, ready for use by the
+    // scan in generateRequiredPrefixScan().
+    void generateRequiredPrefixScanSetup()
+    {
+        if (!supportsFloatingPoint())
+            return;
+
+        move(Imm32(static_cast<int32_t>(splatCharacter(m_requiredPrefix[0]))), regT0);
+        splatInt32ToPacked(regT0, packedPrefixCharacter);
+        if (m_requiredPrefixLength > 1) {
+            move(Imm32(static_cast<int32_t>(splatCharacter(m_requiredPrefix[1]))), regT0);
+            splatInt32ToPacked(regT0, packedNextPrefixCharacter);
+        }
+        if (m_pattern.m_ignoreCase) {
+            move(Imm32(static_cast<int32_t>(splatCharacter(32))), regT0);
+            splatInt32ToPacked(regT0, packedCaseMask);
+        }
+    }
+
+    // Compares the prefix against the characters at a vector's worth of
+    // positions starting from inputPosition, leaving a bitmask of the positions
+    // that matched in result.
+    void matchRequiredPrefixPacked(int inputPosition, RegisterID result)
+    {
+        int characterSize = m_charSize == Char8 ? sizeof(char) : sizeof(UChar);
+
+        loadPacked(BaseIndex(input, index, m_charScale, inputPosition * characterSize), packedInput);
+        if (prefixCharacterIgnoresCase(0))
+            orPacked(packedCaseMask, packedInput);
+        if (m_charSize == Char8)
+            compareEqualPacked8(packedPrefixCharacter, packedInput);
+        else
+            compareEqualPacked16(packedPrefixCharacter, packedInput);
+
+        if (m_requiredPrefixLength > 1) {
+            loadPacked(BaseIndex(input, index, m_charScale, (inputPosition + 1) * characterSize), packedNextInput);
+            if (prefixCharacterIgnoresCase(1))
+                orPacked(packedCaseMask, packedNextInput);
+            if (m_charSize == Char8)
+                compareEqualPacked8(packedNextPrefixCharacter, packedNextInput);
+            else
+                compareEqualPacked16(packedNextPrefixCharacter, packedNextInput);
+            andPacked(packedNextInput, packedInput);
+        }
+
+        movePackedSignBits8ToInt32(packedInput, result);
+    }
+#else
+    void generateRequiredPrefixScanSetup()
+    {
+    }
+#endif
+
+    // Planted at the head of the repeating alternatives. If the required prefix
+    // does not occur at the current position, skip ahead to the next position
+    // at which it does, rather than running the alternatives at every position
+    // in between. If it does not occur again before the input runs out, we
+    // treat this as a failed input check for the first alternative.
+    void generateRequiredPrefixScan(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternAlternative* alternative = op.m_alternative;
+        int inputPosition = -static_cast<int>(alternative->m_minimumSize);
+
+        JumpList mismatch;
+        matchRequiredPrefix(inputPosition, mismatch);
+        Jump matchesHere = jump();
+        mismatch.link(this);
+        add32(TrustedImm32(1), index);
+
+        JumpList foundPrefix;
+        JumpList noInputAvailable;
+#if CPU(X86) || CPU(X86_64)
+        if (supportsFloatingPoint()) {
+            const RegisterID matches = regT0;
+            int charactersPerVector = m_charSize == Char8 ? 16 : 8;
+
+            // Scan a vector's worth of positions at a time, for as long as all
+            // the characters compared lie within the input.
+            Label vectorLoop(this);
+            move(index, regT1);
+            add32(Imm32(inputPosition + charactersPerVector + m_requiredPrefixLength - 1), regT1);
+            Jump pastEndOfInput = branch32(Above, regT1, length);
+
+            matchRequiredPrefixPacked(inputPosition, matches);
+            Jump vectorMatched = branchTest32(NonZero, matches);
+            add32(Imm32(charactersPerVector), index);
+            jump(vectorLoop);
+
+            vectorMatched.link(this);
+            countTrailingZeros32(matches, matches);
+            if (m_charSize == Char16)
+                rshift32(TrustedImm32(1), matches);
+            add32(matches, index);
+            // The vector may extend beyond the last position with enough input
+            // left for the first alternative.
+            foundPrefix.append(checkInput());
+            noInputAvailable.append(jump());
+
+            pastEndOfInput.link(this);
+        }
+#endif
+
+        // Check the remaining positions one at a time.
+        Label characterLoop(this);
+        noInputAvailable.append(jumpIfNoAvailableInput());
+        JumpList characterMismatch;
+        matchRequiredPrefix(inputPosition, characterMismatch);
+        foundPrefix.append(jump());
+        characterMismatch.link(this);
+        add32(TrustedImm32(1), index);
+        jump(characterLoop);
+
+        // We have moved on to a new start position; if the pattern size is
+        // not fixed, store it for use if we match. Later alternatives may still
+        // run after a failed input check, so this is needed there too.
+        noInputAvailable.link(this);
+        storeStartIndex(alternative->m_minimumSize);
+        op.m_jumps.append(jump());
+
+        foundPrefix.link(this);
+        storeStartIndex(alternative->m_minimumSize);
+
+        matchesHere.link(this);
+    }
+
+    void storeStartIndex(unsigned checkedInput)
+    {
+        if (m_pattern.m_body->m_hasFixedSize)
+            return;
+
+        move(index, regT0);
+        sub32(Imm32(checkedInput), regT0);
+        store32(regT0, Address(output));
+    }
+
+    void generateBackReference(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+        unsigned subpatternId = term->backReferenceSubpatternId;
+
+        // We only handle the common case of a single, case-sensitive reference to a
+        // subpattern whose capture is reliably cleared when backtracking; anything
+        // else is left to the interpreter.
+        if (term->quantityType != QuantifierFixedCount || term->quantityCount != 1
+            || m_pattern.m_ignoreCase || m_capturesNotClearedOnBacktrack[subpatternId]) {
+            m_shouldFallBack = true;
+            return;
+        }
+
+        const RegisterID matchBegin = regT0;
+        const RegisterID matchLength = regT1;
+
+        // A reference to a subpattern that has not matched, or matched the empty
+        // string, always succeeds without consuming input.
+        JumpList matchesEmpty;
+        load32(Address(output, (subpatternId << 1) * sizeof(int)), matchBegin);
+        matchesEmpty.append(branch32(Equal, matchBegin, TrustedImm32(-1)));
+        load32(Address(output, ((subpatternId << 1) + 1) * sizeof(int)), matchLength);
+        sub32(matchBegin, matchLength);
+        matchesEmpty.append(branchTest32(Zero, matchLength));
+
+        // Consume the input up front, so that the comparison loop below can run
+        // until the cursor reaches index.
+        add32(matchLength, index);
+        Jump notEnoughInput = branch32(Above, index, length);
+        storeToFrame(matchLength, term->frameLocation);
+
+        // We need two more registers for the comparison loop; borrow output and
+        // length, which are saved on the stack. The frame must not be accessed
+        // until they have been restored.
+        const RegisterID cursor = length;
+        const RegisterID character = output;
+        push(output);
+        push(length);
+
+        // The cursor walks the input consumed by this term; delta is the distance
+        // back from there to the captured substring.
+        move(index, cursor);
+        sub32(matchLength, cursor);
+        const RegisterID delta = matchBegin;
+        sub32(cursor, delta);
+
+        Label loop(this);
+        readCharacter(term->inputPosition - m_checked, character, cursor);
+        move(cursor, matchLength);
+        add32(delta, matchLength);
+        readCharacter(0, matchLength, matchLength);
+        Jump characterMismatch = branch32(NotEqual, character, matchLength);
+        add32(TrustedImm32(1), cursor);
+        branch32(NotEqual, cursor, index).linkTo(loop, this);
+
+        pop(length);
+        pop(output);
+        Jump matched = jump();
+
+        characterMismatch.link(this);
+        pop(length);
+        pop(output);
+        loadFromFrame(term->frameLocation, matchLength);
+        notEnoughInput.link(this);
+        sub32(matchLength, index);
+        op.m_jumps.append(jump());
+
+        matchesEmpty.link(this);
+        storeToFrame(TrustedImm32(0), term->frameLocation);
+
+        matched.link(this);
+    }
+    void backtrackBackReference(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+        const RegisterID matchLength = regT1;
+
+        // Give back the input consumed by the reference; there are no other
+        // matches to try.
+        m_backtrackingState.link(this);
+        loadFromFrame(term->frameLocation, matchLength);
+        sub32(matchLength, index);
+        m_backtrackingState.fallthrough();
+
+        m_backtrackingState.append(op.m_jumps);
+    }
+
     void generateDotStarEnclosure(size_t opIndex)
     {
         YarrOp& op = m_ops[opIndex];
@@ -1187,7 +1437,7 @@ class YarrGenerator : private MacroAssembler {
         case PatternTerm::TypeParentheticalAssertion:
             ASSERT_NOT_REACHED();
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+            generateBackReference(opIndex);
             break;
         case PatternTerm::TypeDotStarEnclosure:
             generateDotStarEnclosure(opIndex);
@@ -1258,7 +1508,7 @@ class YarrGenerator : private MacroAssembler {
             break;
 
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+            backtrackBackReference(opIndex);
             break;
         }
     }
@@ -1301,6 +1551,10 @@ class YarrGenerator : private MacroAssembler {
             // position to still reflect that expected by the prior alternative.
             case OpBodyAlternativeBegin: {
                 PatternAlternative* alternative = op.m_alternative;
+                bool scanForRequiredPrefix = m_requiredPrefixLength && !alternative->onceThrough();
+
+                if (scanForRequiredPrefix)
+                    generateRequiredPrefixScanSetup();
 
                 // Upon entry at the head of the set of alternatives, check if input is available
                 // to run the first alternative. (This progresses the input position).
@@ -1309,6 +1563,9 @@ class YarrGenerator : private MacroAssembler {
                 // set as appropriate to this alternative.
                 op.m_reentry = label();
 
+                if (scanForRequiredPrefix)
+                    generateRequiredPrefixScan(opIndex);
+
                 m_checked += alternative->m_minimumSize;
                 break;
             }
@@ -2232,6 +2489,9 @@ class YarrGenerator : private MacroAssembler {
             // Select the 'Terminal' nodes.
             parenthesesBeginOpCode = OpParenthesesSubpatternTerminalBegin;
             parenthesesEndOpCode = OpParenthesesSubpatternTerminalEnd;
+
+            // Captures from an earlier iteration survive a failed one.
+            markCapturesNotClearedOnBacktrack(term);
         } else {
             // This subpattern is not supported by the JIT.
             m_shouldFallBack = true;
@@ -2289,6 +2549,10 @@ class YarrGenerator : private MacroAssembler {
     // once, and will never backtrack back into the assertion.
     void opCompileParentheticalAssertion(PatternTerm* term)
     {
+        // We never backtrack into an assertion, so captures made within it are
+        // not cleared when backtracking past it.
+        markCapturesNotClearedOnBacktrack(term);
+
         size_t parenBegin = m_ops.size();
         m_ops.append(OpParentheticalAssertionBegin);
 
@@ -2330,6 +2594,15 @@ class YarrGenerator : private MacroAssembler {
         m_ops[parenEnd].m_nextOp = notFound;
     }
 
+    // markCapturesNotClearedOnBacktrack
+    // Records the subpatterns captured within the given parentheses as ones
+    // whose capture may be stale when a backreference to them is matched.
+    void markCapturesNotClearedOnBacktrack(PatternTerm* term)
+    {
+        for (unsigned i = term->parentheses.subpatternId; i <= term->parentheses.lastSubpatternId; ++i)
+            m_capturesNotClearedOnBacktrack[i] = true;
+    }
+
     // opCompileAlternative
     // Called to emit nodes for all terms in an alternative.
     void opCompileAlternative(PatternAlternative* alternative)
@@ -2354,6 +2627,47 @@ class YarrGenerator : private MacroAssembler {
         }
     }
 
+    // findRequiredPrefix
+    // Looks for up to two literal characters that every repeating alternative
+    // starts with; a match can only start at a position where these occur.
+    // This must run before opCompileAlternative reorders the terms.
+    void findRequiredPrefix(Vector<PatternAlternative*>& alternatives, size_t firstRepeatingAlternative)
+    {
+        m_requiredPrefixLength = maxRequiredPrefixLength;
+
+        for (size_t i = firstRepeatingAlternative; i < alternatives.size(); ++i) {
+            Vector<PatternTerm>& terms = alternatives[i]->m_terms;
+            unsigned length = 0;
+
+            for (unsigned j = 0; j < terms.size() && length < m_requiredPrefixLength; ++j) {
+                PatternTerm& term = terms[j];
+                if (term.type != PatternTerm::TypePatternCharacter
+                    || term.quantityType != QuantifierFixedCount
+                    || term.inputPosition != static_cast<int>(length))
+                    break;
+
+                UChar ch = term.patternCharacter;
+                if (m_pattern.m_ignoreCase && isASCIIAlpha(ch))
+                    ch = toASCIILower(ch);
+                // Nothing can match an 8-bit string here; leave it to the normal matching code.
+                if (ch > 0xff && m_charSize == Char8)
+                    break;
+
+                unsigned count = term.quantityCount.unsafeGet();
+                unsigned k = 0;
+                for (; k < count && length < m_requiredPrefixLength; ++k, ++length) {
+                    if (i != firstRepeatingAlternative && m_requiredPrefix[length] != ch)
+                        break;
+                    m_requiredPrefix[length] = ch;
+                }
+                if (k < count)
+                    break;
+            }
+
+            m_requiredPrefixLength = length;
+        }
+    }
+
     // opCompileBody
     // This method compiles the body disjunction of the regular expression.
     // The body consists of two sets of alternatives - zero or more 'once
@@ -2409,6 +2723,7 @@ class YarrGenerator : private MacroAssembler {
         }
 
         // Emit the repeated alternatives.
+        findRequiredPrefix(alternatives, currentAlternativeIndex);
         size_t repeatLoop = m_ops.size();
         m_ops.append(YarrOp(OpBodyAlternativeBegin));
         m_ops.last().m_previousOp = notFound;
@@ -2507,6 +2822,7 @@ public:
         , m_charSize(charSize)
         , m_charScale(m_charSize == Char8 ? TimesOne: TimesTwo)
         , m_shouldFallBack(false)
+        , m_requiredPrefixLength(0)
         , m_checked(0)
     {
     }
@@ -2530,10 +2846,11 @@ public:
             subPtr(Imm32(m_pattern.m_body->m_callFrameSize * sizeof(void*)), stackPointerRegister);
 
         // Compile the pattern to the internal 'YarrOp' representation.
+        m_capturesNotClearedOnBacktrack.fill(false, m_pattern.m_numSubpatterns + 1);
         opCompileBody(m_pattern.m_body);
 
         // If we encountered anything we can't handle in the JIT code
-        // (e.g. backreferences) then return early.
+        // (e.g. nested quantified parentheses) then return early.
         if (m_shouldFallBack) {
             jitObject.setFallBack(true);
             return;
@@ -2566,6 +2883,15 @@ private:
     // The regular expression expressed as a linear sequence of operations.
     Vector<YarrOp, 128> m_ops;
 
+    // Subpatterns whose captures are not reset when backtracking, and as such
+    // may not be referenced from JIT code.
+    Vector<bool, 16> m_capturesNotClearedOnBacktrack;
+
+    // Literal characters every repeating alternative starts with, if any.
+    static const unsigned maxRequiredPrefixLength = 2;
+    UChar m_requiredPrefix[maxRequiredPrefixLength];
+    unsigned m_requiredPrefixLength;
+
     // This records the current input offset being applied due to the current
     // set of alternatives we are nested within. E.g. when matching the
     // character 'b' within the regular expression /abc/, we will know that
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "SourceProviderCacheStorage.h"
+
+#include "FileSystem.h"
+#include "JSDOMWindowBase.h"
+#include <parser/SourceProviderCache.h>
+#include <wtf/HexNumber.h>
+#include <wtf/MainThread.h>
+#include <wtf/SHA1.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace WebCore {
+
+static const char fileMagic[4] = { 'J', 'S', 'P', 'C' };
+static const uint32_t fileFormatVersion = 1;
+
+// Scripts shorter than this parse quickly enough that the disk round trip is
+// not worth it.
+static const unsigned minimumSourceLengthToStore = 16 * 1024;
+// Files are read on the main thread right before a parse, so they must stay
+// small enough to read and decode in a few milliseconds.
+static const long long maximumFileSize = 2 * 1024 * 1024;
+// Caches are only an optimization: drop writes rather than queue up more than
+// this for the writer thread.
+static const size_t maximumPendingWriteBytes = 8 * 1024 * 1024;
+
+// Below this, hashing the source costs about as much as the parse it saves.
+static const unsigned minimumSourceLengthToShare = 1024;
+// Caches not used by any live provider are dropped, least recently used
+// first, once all shared caches together grow beyond this.
+static const unsigned maximumSharedCachesSize = 4 * 1024 * 1024;
+
+struct SourceProviderCacheFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sourceLength;
+    uint32_t payloadLength;
+};
+
+SourceProviderCacheStorage& SourceProviderCacheStorage::shared()
+{
+    DEFINE_STATIC_LOCAL(SourceProviderCacheStorage, storage, ());
+    return storage;
+}
+
+SourceProviderCacheStorage::SourceProviderCacheStorage()
+    : m_writerThread(0)
+    , m_pendingWriteBytes(0)
+{
+}
+
+void SourceProviderCacheStorage::setCacheDirectory(const String& cacheDirectory)
+{
+    m_cacheDirectory = cacheDirectory;
+}
+
+bool SourceProviderCacheStorage::isWorthStoring(const String& source)
+{
+    return source.length() >= minimumSourceLengthToStore;
+}
+
+String SourceProviderCacheStorage::keyForSource(const String& source)
+{
+    SHA1 sha1;
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(source.characters()), source.length() * sizeof(UChar));
+    Vector<uint8_t, 20> hash;
+    sha1.computeHash(hash);
+
+    StringBuilder key;
+    for (size_t i = 0; i < hash.size(); ++i)
+        appendByteAsHex(hash[i], key, Lowercase);
+    return key.toString();
+}
+
+PassRefPtr<JSC::SourceProviderCache> SourceProviderCacheStorage::cacheForSource(const String& source, const TextPosition& startPosition, String* key)
+{
+    if (!isMainThread() || source.length() < minimumSourceLengthToShare)
+        return 0;
+
+    // Only whole files go to disk, and those always start on the first line.
+    bool startsOnFirstLine = !startPosition.m_line.zeroBasedInt();
+    String sourceKey = keyForSource(source);
+    if (!startsOnFirstLine)
+        sourceKey.append(String::format("@%d", startPosition.m_line.zeroBasedInt()));
+    if (key)
+        *key = sourceKey;
+
+    SharedCacheMap::iterator it = m_sharedCaches.find(sourceKey);
+    if (it != m_sharedCaches.end()) {
+        m_sharedCacheUseOrder.remove(sourceKey);
+        m_sharedCacheUseOrder.add(sourceKey);
+        return it->second;
+    }
+
+    RefPtr<JSC::SourceProviderCache> cache = JSC::SourceProviderCache::create();
+    if (startsOnFirstLine && isWorthStoring(source))
+        load(sourceKey, source, cache.get());
+    m_sharedCaches.set(sourceKey, cache);
+    m_sharedCacheUseOrder.add(sourceKey);
+    pruneSharedCaches();
+    return cache.release();
+}
+
+void SourceProviderCacheStorage::pruneSharedCaches()
+{
+    unsigned size = 0;
+    SharedCacheMap::iterator end = m_sharedCaches.end();
+    for (SharedCacheMap::iterator it = m_sharedCaches.begin(); it != end; ++it)
+        size += it->second->byteSize();
+
+    ListHashSet<String>::iterator it = m_sharedCacheUseOrder.begin();
+    while (size > maximumSharedCachesSize && it != m_sharedCacheUseOrder.end()) {
+        ListHashSet<String>::iterator current = it;
+        ++it;
+        SharedCacheMap::iterator entry = m_sharedCaches.find(*current);
+        ASSERT(entry != m_sharedCaches.end());
+        // A cache that a live provider still holds would not be freed anyway.
+        if (!entry->second->hasOneRef())
+            continue;
+        size -= entry->second->byteSize();
+        m_sharedCaches.remove(entry);
+        m_sharedCacheUseOrder.remove(current);
+    }
+}
+
+String SourceProviderCacheStorage::pathForKey(const String& key) const
+{
+    return pathByAppendingComponent(m_cacheDirectory, key);
+}
+
+bool SourceProviderCacheStorage::load(const String& key, const String& source, JSC::SourceProviderCache* cache)
+{
+    if (m_cacheDirectory.isEmpty() || key.isEmpty())
+        return false;
+
+    String path = pathForKey(key);
+    // The writer thread may be halfway through this file.
+    if (m_pendingWritePaths.contains(path))
+        return false;
+
+    long long fileSize;
+    if (!getFileSize(path, fileSize) || fileSize < static_cast<long long>(sizeof(SourceProviderCacheFileHeader)) || fileSize > maximumFileSize)
+        return false;
+
+    PlatformFileHandle handle = openFile(path, OpenForRead);
+    if (!isHandleValid(handle))
+        return false;
+    Vector<char> data(fileSize);
+    bool didReadFile = readFromFile(handle, data.data(), data.size()) == static_cast<int>(data.size());
+    closeFile(handle);
+    if (!didReadFile)
+        return false;
+
+    SourceProviderCacheFileHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    bool isValid = !memcmp(header.magic, fileMagic, sizeof(fileMagic))
+        && header.version == fileFormatVersion
+        && header.sourceLength == source.length()
+        && header.payloadLength == data.size() - sizeof(header)
+        && cache->decode(JSDOMWindowBase::commonJSGlobalData(), data.data() + sizeof(header), header.payloadLength);
+    if (!isValid) {
+        // Written by another version, or truncated by a crash; it will be
+        // rewritten once the script has been parsed again.
+        deleteFile(path);
+        return false;
+    }
+    return true;
+}
+
+void SourceProviderCacheStorage::store(const String& key, const String& source, const JSC::SourceProviderCache* cache)
+{
+    ASSERT(isMainThread());
+    if (m_cacheDirectory.isEmpty() || key.isEmpty() || m_pendingWriteBytes >= maximumPendingWriteBytes)
+        return;
+
+    OwnPtr<PendingWrite> write = adoptPtr(new PendingWrite);
+    write->data.resize(sizeof(SourceProviderCacheFileHeader));
+    cache->encode(write->data);
+    if (write->data.size() > static_cast<size_t>(maximumFileSize))
+        return;
+
+    SourceProviderCacheFileHeader header;
+    memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileFormatVersion;
+    header.sourceLength = source.length();
+    header.payloadLength = write->data.size() - sizeof(header);
+    memcpy(write->data.data(), &header, sizeof(header));
+
+    write->path = pathForKey(key);
+    write->isolatedDirectory = m_cacheDirectory.isolatedCopy();
+    write->isolatedPath = write->path.isolatedCopy();
+
+    m_pendingWritePaths.add(write->path);
+    m_pendingWriteBytes += write->data.size();
+    m_pendingWrites.append(write.release());
+
+    if (!m_writerThread) {
+        m_writerThread = createThread(writerThreadEntry, this, "WebCore: SourceProviderCacheStorage");
+        // The storage lives as long as the process, and pending writes are
+        // not worth delaying its exit for.
+        detachThread(m_writerThread);
+    }
+}
+
+void SourceProviderCacheStorage::writerThreadEntry(void* storage)
+{
+    static_cast<SourceProviderCacheStorage*>(storage)->runWriterLoop();
+}
+
+void SourceProviderCacheStorage::runWriterLoop()
+{
+    ASSERT(!isMainThread());
+    while (OwnPtr<PendingWrite> write = m_pendingWrites.waitForMessage()) {
+        writeFile(*write);
+        callOnMainThread(didWriteFileDispatch, write.leakPtr());
+    }
+}
+
+void SourceProviderCacheStorage::writeFile(const PendingWrite& write)
+{
+    if (!makeAllDirectories(write.isolatedDirectory))
+        return;
+
+    // Opening for writing does not truncate on every platform, so a shorter
+    // rewrite would leave the end of the old file behind.
+    deleteFile(write.isolatedPath);
+    PlatformFileHandle handle = openFile(write.isolatedPath, OpenForWrite);
+    if (!isHandleValid(handle))
+        return;
+    bool didWriteFile = writeToFile(handle, write.data.data(), write.data.size()) == static_cast<int>(write.data.size());
+    closeFile(handle);
+    if (!didWriteFile)
+        deleteFile(write.isolatedPath);
+}
+
+void SourceProviderCacheStorage::didWriteFileDispatch(void* write)
+{
+    shared().didWriteFile(adoptPtr(static_cast<PendingWrite*>(write)));
+}
+
+void SourceProviderCacheStorage::didWriteFile(PassOwnPtr<PendingWrite> write)
+{
+    ASSERT(isMainThread());
+    m_pendingWritePaths.remove(write->path);
+    ASSERT(m_pendingWriteBytes >= write->data.size());
+    m_pendingWriteBytes -= write->data.size();
+}
+
+} // namespace WebCore
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef SourceProviderCacheStorage_h
+#define SourceProviderCacheStorage_h
+
+#include "PlatformString.h"
+#include <wtf/HashCountedSet.h>
+#include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/MessageQueue.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringHash.h>
+#include <wtf/text/TextPosition.h>
+
+namespace JSC {
+    class SourceProviderCache;
+}
+
+namespace WebCore {
+
+    // Keeps the parser's SourceProviderCache alive across navigations, and on
+    // disk for large scripts, so that a later parse of the same source text can
+    // skip the bodies of functions that were seen before. Entries are keyed by
+    // a hash of the source text, not by URL, so a changed script can never be
+    // matched with stale function boundaries.
+    class SourceProviderCacheStorage {
+        WTF_MAKE_NONCOPYABLE(SourceProviderCacheStorage); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        static SourceProviderCacheStorage& shared();
+
+        void setCacheDirectory(const String&);
+        const String& cacheDirectory() const { return m_cacheDirectory; }
+
+        static bool isWorthStoring(const String& source);
+        static String keyForSource(const String& source);
+
+        // Returns the cache shared by every main thread provider of this source
+        // text, or 0 if the source is too short to be worth it. Other threads
+        // have their own identifier tables, so they cannot share caches. The
+        // cached function boundaries carry line numbers, so sources that start
+        // on different lines get different caches.
+        PassRefPtr<JSC::SourceProviderCache> cacheForSource(const String& source, const TextPosition& startPosition, String* key = 0);
+
+        // Loading reads the file synchronously, since the cache is needed by
+        // the parse that is about to start; files are kept small enough for
+        // that. Storing encodes the cache and hands the file to a background
+        // thread.
+        bool load(const String& key, const String& source, JSC::SourceProviderCache*);
+        void store(const String& key, const String& source, const JSC::SourceProviderCache*);
+
+    private:
+        SourceProviderCacheStorage();
+
+        String pathForKey(const String& key) const;
+        void pruneSharedCaches();
+
+        struct PendingWrite {
+            WTF_MAKE_FAST_ALLOCATED;
+        public:
+            String path;
+            String isolatedDirectory;
+            String isolatedPath;
+            Vector<char> data;
+        };
+
+        static void writerThreadEntry(void*);
+        void runWriterLoop();
+        static void writeFile(const PendingWrite&);
+        static void didWriteFileDispatch(void*);
+        void didWriteFile(PassOwnPtr<PendingWrite>);
+
+        String m_cacheDirectory;
+
+        typedef HashMap<String, RefPtr<JSC::SourceProviderCache> > SharedCacheMap;
+        SharedCacheMap m_sharedCaches;
+        ListHashSet<String> m_sharedCacheUseOrder;
+
+        ThreadIdentifier m_writerThread;
+        MessageQueue<PendingWrite> m_pendingWrites;
+        // Only touched on the main thread.
+        HashCountedSet<String> m_pendingWritePaths;
+        size_t m_pendingWriteBytes;
+    };
+
+} // namespace WebCore
+
+#endif // SourceProviderCacheStorage_h
@@ -31,6 +31,7 @@
 
 #include "JSDOMBinding.h"
 #include "ScriptSourceProvider.h"
+#include "SourceProviderCacheStorage.h"
 #include <parser/SourceCode.h>
 
 namespace WebCore {
@@ -49,7 +50,7 @@ namespace WebCore {
 
     private:
         StringSourceProvider(const String& source, const String& url, const TextPosition& startPosition)
-            : ScriptSourceProvider(stringToUString(url), startPosition)
+            : ScriptSourceProvider(stringToUString(url), startPosition, SourceProviderCacheStorage::shared().cacheForSource(source, startPosition))
             , m_source(source)
         {
         }
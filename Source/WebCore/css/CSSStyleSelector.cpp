@@ -90,11 +90,13 @@
 #include "RotateTransformOperation.h"
 #include "ScaleTransformOperation.h"
 #include "SecurityOrigin.h"
+#include "SelectorCompiler.h"
 #include "Settings.h"
 #include "ShadowData.h"
 #include "ShadowValue.h"
 #include "SkewTransformOperation.h"
 #include "StyleCachedImage.h"
+#include "StyleInvalidationSet.h"
 #include "StylePendingImage.h"
 #include "StyleGeneratedImage.h"
 #include "StyleSheetList.h"
@@ -135,12 +137,30 @@
 #include "WebKitCSSShaderValue.h"
 #endif
 
+#define DUMP_SELECTOR_FILTER_STATISTICS 0
+
 using namespace std;
 
 namespace WebCore {
 
 using namespace HTMLNames;
 
+#if DUMP_SELECTOR_FILTER_STATISTICS
+static size_t candidateRuleCount;
+static size_t ancestorFilterRejectCount;
+static size_t siblingFilterRejectCount;
+static size_t attributeFilterRejectCount;
+
+static void dumpSelectorFilterStatistics()
+{
+    printf("Selector filter statistics:\n");
+    printf("  Candidate rules: %zu\n", candidateRuleCount);
+    printf("  Rejected by the ancestor filter: %zu\n", ancestorFilterRejectCount);
+    printf("  Rejected by the attribute filter: %zu\n", attributeFilterRejectCount);
+    printf("  Rejected by the sibling filter: %zu\n", siblingFilterRejectCount);
+}
+#endif
+
 #define HANDLE_INHERIT(prop, Prop) \
 if (isInherit) { \
     m_style->set##Prop(m_parentStyle->prop()); \
@@ -186,17 +206,34 @@ public:
     unsigned specificity() const { return m_specificity; }
     unsigned linkMatchType() const { return m_linkMatchType; }
 
+#if ENABLE(CSS_SELECTOR_JIT)
+    // Compiles the selector once it has gone through the slow path often enough.
+    CompiledSelector* compiledSelector() const;
+#endif
+
     // Try to balance between memory usage (there can be lots of RuleData objects) and good filtering performance.
     static const unsigned maximumIdentifierCount = 4;
     const unsigned* descendantSelectorIdentifierHashes() const { return m_descendantSelectorIdentifierHashes; }
+    static const unsigned maximumSiblingIdentifierCount = 2;
+    const unsigned* siblingSelectorIdentifierHashes() const { return m_siblingSelectorIdentifierHashes; }
+    unsigned subjectAttributeNameMask() const { return m_subjectAttributeNameMask; }
+    bool hasDirectAdjacentSiblingSelector() const { return m_hasDirectAdjacentSiblingSelector; }
+    bool hasIndirectAdjacentSiblingSelector() const { return m_hasIndirectAdjacentSiblingSelector; }
 
 private:
     CSSStyleRule* m_rule;
     CSSSelector* m_selector;
-    unsigned m_specificity;
+    unsigned m_specificity : 24;
+#if ENABLE(CSS_SELECTOR_JIT)
+    mutable unsigned m_slowPathCheckCount : 7;
+    mutable unsigned m_isCompilableSelector : 1;
+#endif
     // This number was picked fairly arbitrarily. We can probably lower it if we need to.
     // Some simple testing showed <100,000 RuleData's on large sites.
-    unsigned m_position : 26;
+    unsigned m_position : 24;
+    // Whether the combinators between the rightmost compound selector and the first ancestor one include + or ~.
+    unsigned m_hasDirectAdjacentSiblingSelector : 1;
+    unsigned m_hasIndirectAdjacentSiblingSelector : 1;
     unsigned m_hasFastCheckableSelector : 1;
     unsigned m_hasMultipartSelector : 1;
     unsigned m_hasRightmostSelectorMatchingHTMLBasedOnRuleHash : 1;
@@ -204,6 +241,11 @@ private:
     unsigned m_linkMatchType : 2; //  SelectorChecker::LinkMatchMask
     // Use plain array instead of a Vector to minimize memory overhead.
     unsigned m_descendantSelectorIdentifierHashes[maximumIdentifierCount];
+    unsigned m_siblingSelectorIdentifierHashes[maximumSiblingIdentifierCount];
+    unsigned m_subjectAttributeNameMask;
+#if ENABLE(CSS_SELECTOR_JIT)
+    mutable RefPtr<CompiledSelector> m_compiledSelector;
+#endif
 };
     
 struct SameSizeAsRuleData {
@@ -212,10 +254,33 @@ struct SameSizeAsRuleData {
     unsigned c;
     unsigned d;
     unsigned e[4];
+    unsigned f[2];
+    unsigned g;
+#if ENABLE(CSS_SELECTOR_JIT)
+    void* h;
+#endif
 };
 
 COMPILE_ASSERT(sizeof(RuleData) == sizeof(SameSizeAsRuleData), RuleData_should_stay_small);
 
+#if ENABLE(CSS_SELECTOR_JIT)
+inline CompiledSelector* RuleData::compiledSelector() const
+{
+    if (!m_isCompilableSelector)
+        return m_compiledSelector.get();
+
+    // Rules that are only checked a few times are not worth the executable memory.
+    // This number was picked fairly arbitrarily as well.
+    static const unsigned slowPathChecksBeforeCompiling = 100;
+    if (++m_slowPathCheckCount < slowPathChecksBeforeCompiling)
+        return 0;
+
+    m_isCompilableSelector = false;
+    m_compiledSelector = SelectorCompiler::compile(m_selector);
+    return m_compiledSelector.get();
+}
+#endif
+
 class RuleSet {
     WTF_MAKE_NONCOPYABLE(RuleSet);
 public:
@@ -272,6 +337,8 @@ static RuleSet* defaultQuirksStyle;
 static RuleSet* defaultPrintStyle;
 static RuleSet* defaultViewSourceStyle;
 static CSSStyleSheet* simpleDefaultStyleSheet;
+// Bumped whenever defaultStyle gains rules, so style selectors know to collect its features again.
+static unsigned defaultStyleGeneration;
 
 RenderStyle* CSSStyleSelector::s_styleNotYetAvailable;
 
@@ -316,7 +383,8 @@ static StylePropertySet* rightToLeftDeclaration()
 CSSStyleSelector::CSSStyleSelector(Document* document, StyleSheetList* styleSheets, CSSStyleSheet* mappedElementSheet,
                                    CSSStyleSheet* pageUserSheet, const Vector<RefPtr<CSSStyleSheet> >* pageGroupUserSheets, const Vector<RefPtr<CSSStyleSheet> >* documentUserSheets,
                                    bool strictParsing, bool matchAuthorAndUserStyles)
-    : m_hasUAAppearance(false)
+    : m_featuresDefaultStyleGeneration(0)
+    , m_hasUAAppearance(false)
     , m_backgroundData(BackgroundFillLayer)
     , m_matchedPropertiesCacheAdditionsSinceLastSweep(0)
     , m_checker(document, strictParsing)
@@ -331,6 +399,8 @@ CSSStyleSelector::CSSStyleSelector(Document* document, StyleSheetList* styleShee
     , m_fontDirty(false)
     , m_matchAuthorAndUserStyles(matchAuthorAndUserStyles)
     , m_sameOriginOnly(false)
+    , m_elementAttributeNameMask(0)
+    , m_elementAttributeNameMaskIsValid(false)
     , m_fontSelector(CSSFontSelector::create(document))
     , m_applyPropertyToRegularStyle(true)
     , m_applyPropertyToVisitedLinkStyle(false)
@@ -437,6 +507,7 @@ void CSSStyleSelector::collectFeatures()
 #endif
     if (m_userStyle)
         m_features.add(m_userStyle->features());
+    m_featuresDefaultStyleGeneration = defaultStyleGeneration;
 
     m_siblingRuleSet = makeRuleSet(m_features.siblingRules);
     m_uncommonAttributeRuleSet = makeRuleSet(m_features.uncommonAttributeRules);
@@ -570,6 +641,9 @@ void CSSStyleSelector::addKeyframeStyle(PassRefPtr<WebKitCSSKeyframesRule> rule)
 CSSStyleSelector::~CSSStyleSelector()
 {
     m_fontSelector->clearDocument();
+#if DUMP_SELECTOR_FILTER_STATISTICS
+    dumpSelectorFilterStatistics();
+#endif
 }
 
 void CSSStyleSelector::sweepMatchedPropertiesCache()
@@ -604,6 +678,21 @@ CSSStyleSelector::Features::~Features()
 {
 }
     
+static StyleInvalidationSet& ensureInvalidationSet(CSSStyleSelector::Features::InvalidationSetMap& map, AtomicStringImpl* key)
+{
+    OwnPtr<StyleInvalidationSet>& invalidationSet = map.add(key, nullptr).first->second;
+    if (!invalidationSet)
+        invalidationSet = StyleInvalidationSet::create();
+    return *invalidationSet;
+}
+
+static void addInvalidationSets(CSSStyleSelector::Features::InvalidationSetMap& map, const CSSStyleSelector::Features::InvalidationSetMap& other)
+{
+    CSSStyleSelector::Features::InvalidationSetMap::const_iterator end = other.end();
+    for (CSSStyleSelector::Features::InvalidationSetMap::const_iterator it = other.begin(); it != end; ++it)
+        ensureInvalidationSet(map, it->first).add(*it->second);
+}
+
 void CSSStyleSelector::Features::add(const CSSStyleSelector::Features& other)
 {
     HashSet<AtomicStringImpl*>::iterator end = other.idsInRules.end();
@@ -612,6 +701,9 @@ void CSSStyleSelector::Features::add(const CSSStyleSelector::Features& other)
     end = other.attrsInRules.end();
     for (HashSet<AtomicStringImpl*>::iterator it = other.attrsInRules.begin(); it != end; ++it)
         attrsInRules.add(*it);
+    addInvalidationSets(classInvalidationSets, other.classInvalidationSets);
+    addInvalidationSets(idInvalidationSets, other.idInvalidationSets);
+    addInvalidationSets(attributeInvalidationSets, other.attributeInvalidationSets);
     siblingRules.append(other.siblingRules);
     uncommonAttributeRules.append(other.uncommonAttributeRules);
     usesFirstLineRules = usesFirstLineRules || other.usesFirstLineRules;
@@ -623,6 +715,9 @@ void CSSStyleSelector::Features::clear()
 {
     idsInRules.clear();
     attrsInRules.clear();
+    classInvalidationSets.clear();
+    idInvalidationSets.clear();
+    attributeInvalidationSets.clear();
     siblingRules.clear();
     uncommonAttributeRules.clear();
     usesFirstLineRules = false;
@@ -665,6 +760,8 @@ static void loadFullDefaultStyle()
     defaultStyle->addRulesFromSheet(defaultSheet, screenEval());
     defaultPrintStyle->addRulesFromSheet(defaultSheet, printEval());
 
+    ++defaultStyleGeneration;
+
     // Quirks-mode rules.
     String quirksRules = String(quirksUserAgentStyleSheet, sizeof(quirksUserAgentStyleSheet)) + RenderTheme::defaultTheme()->extraQuirksStyleSheet();
     CSSStyleSheet* quirksSheet = parseUASheet(quirksRules);
@@ -707,6 +804,7 @@ static void ensureDefaultStyleSheetsForElement(Element* element)
         CSSStyleSheet* svgSheet = parseUASheet(svgUserAgentStyleSheet, sizeof(svgUserAgentStyleSheet));
         defaultStyle->addRulesFromSheet(svgSheet, screenEval());
         defaultPrintStyle->addRulesFromSheet(svgSheet, printEval());
+        ++defaultStyleGeneration;
     }
 #endif
 
@@ -718,6 +816,7 @@ static void ensureDefaultStyleSheetsForElement(Element* element)
         CSSStyleSheet* mathMLSheet = parseUASheet(mathmlUserAgentStyleSheet, sizeof(mathmlUserAgentStyleSheet));
         defaultStyle->addRulesFromSheet(mathMLSheet, screenEval());
         defaultPrintStyle->addRulesFromSheet(mathMLSheet, printEval());
+        ++defaultStyleGeneration;
     }
 #endif
 
@@ -729,6 +828,7 @@ static void ensureDefaultStyleSheetsForElement(Element* element)
         CSSStyleSheet* mediaControlsSheet = parseUASheet(mediaRules);
         defaultStyle->addRulesFromSheet(mediaControlsSheet, screenEval());
         defaultPrintStyle->addRulesFromSheet(mediaControlsSheet, printEval());
+        ++defaultStyleGeneration;
     }
 #endif
 
@@ -740,6 +840,7 @@ static void ensureDefaultStyleSheetsForElement(Element* element)
         CSSStyleSheet* fullscreenSheet = parseUASheet(fullscreenRules);
         defaultStyle->addRulesFromSheet(fullscreenSheet, screenEval());
         defaultQuirksStyle->addRulesFromSheet(fullscreenSheet, screenEval());
+        ++defaultStyleGeneration;
     }
 #endif
 
@@ -931,18 +1032,68 @@ inline bool MatchingUARulesScope::isMatchingUARules()
 
 bool MatchingUARulesScope::m_matchingUARules = false;
 
+inline unsigned CSSStyleSelector::elementAttributeNameMask()
+{
+    if (!m_elementAttributeNameMaskIsValid) {
+        m_elementAttributeNameMask = SelectorChecker::elementAttributeNameMask(m_element);
+        m_elementAttributeNameMaskIsValid = true;
+    }
+    return m_elementAttributeNameMask;
+}
+
+inline bool CSSStyleSelector::fastRejectSelector(const RuleData& ruleData, bool canUseParentStack)
+{
+#if DUMP_SELECTOR_FILTER_STATISTICS
+    ++candidateRuleCount;
+#endif
+    if (canUseParentStack && m_checker.fastRejectSelector<RuleData::maximumIdentifierCount>(ruleData.descendantSelectorIdentifierHashes())) {
+#if DUMP_SELECTOR_FILTER_STATISTICS
+        ++ancestorFilterRejectCount;
+#endif
+        return true;
+    }
+
+    unsigned attributeNameMask = ruleData.subjectAttributeNameMask();
+    if (attributeNameMask && (elementAttributeNameMask() & attributeNameMask) != attributeNameMask) {
+#if DUMP_SELECTOR_FILTER_STATISTICS
+        ++attributeFilterRejectCount;
+#endif
+        return true;
+    }
+
+    if (canUseParentStack && ruleData.siblingSelectorIdentifierHashes()[0]
+        && m_checker.fastRejectSiblingSelector<RuleData::maximumSiblingIdentifierCount>(m_element, ruleData.siblingSelectorIdentifierHashes())) {
+        // SelectorChecker marks the parent style as soon as the rightmost compound selector matches, so that
+        // inserting a sibling later restyles this element. We don't know whether it would have matched.
+        if (!m_checker.isCollectingRulesOnly() && m_element->parentElement()) {
+            RenderStyle* parentStyle = style() ? (m_parentNode ? m_parentNode->renderStyle() : 0) : m_element->parentNode()->renderStyle();
+            if (parentStyle) {
+                if (ruleData.hasDirectAdjacentSiblingSelector())
+                    parentStyle->setChildrenAffectedByDirectAdjacentRules();
+                if (ruleData.hasIndirectAdjacentSiblingSelector())
+                    parentStyle->setChildrenAffectedByForwardPositionalRules();
+            }
+        }
+#if DUMP_SELECTOR_FILTER_STATISTICS
+        ++siblingFilterRejectCount;
+#endif
+        return true;
+    }
+    return false;
+}
+
 void CSSStyleSelector::collectMatchingRulesForList(const Vector<RuleData>* rules, int& firstRuleIndex, int& lastRuleIndex, const MatchOptions& options)
 {
     if (!rules)
         return;
     // In some cases we may end up looking up style for random elements in the middle of a recursive tree resolve.
-    // Ancestor identifier filter won't be up-to-date in that case and we can't use the fast path.
-    bool canUseFastReject = m_checker.parentStackIsConsistent(m_parentNode);
+    // Ancestor and sibling identifier filters won't be up-to-date in that case and we can't use them.
+    bool canUseParentStack = m_checker.parentStackIsConsistent(m_parentNode);
 
     unsigned size = rules->size();
     for (unsigned i = 0; i < size; ++i) {
         const RuleData& ruleData = rules->at(i);
-        if (canUseFastReject && m_checker.fastRejectSelector<RuleData::maximumIdentifierCount>(ruleData.descendantSelectorIdentifierHashes()))
+        if (fastRejectSelector(ruleData, canUseParentStack))
             continue;
 
         CSSStyleRule* rule = ruleData.rule();
@@ -1098,6 +1249,8 @@ inline void CSSStyleSelector::initForStyleResolve(Element* e, RenderStyle* paren
 
     m_style = 0;
 
+    m_elementAttributeNameMaskIsValid = false;
+
     m_pendingImageProperties.clear();
 
     m_ruleList = 0;
@@ -1544,6 +1697,11 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* element, Rend
     }
 
     ensureDefaultStyleSheetsForElement(element);
+    // Class, id and attribute changes only restyle what the invalidation sets in m_features
+    // name, so pick up UA rules that were loaded after the features were collected. The
+    // root default style is resolved in the constructor, before there are features to refresh.
+    if (m_authorStyle && m_featuresDefaultStyleGeneration != defaultStyleGeneration)
+        collectFeatures();
 
     MatchResult matchResult;
     if (resolveForRootDefault)
@@ -2122,6 +2280,18 @@ inline bool CSSStyleSelector::checkSelector(const RuleData& ruleData, const Elem
         return m_checker.fastCheckSelector(ruleData.selector(), m_element);
     }
 
+#if ENABLE(CSS_SELECTOR_JIT)
+    // The compiled selectors have no pseudo elements, and leave SVG to the slow path like the fast path does.
+    if (!scope && !m_element->isSVGElement()) {
+        if (CompiledSelector* compiledSelector = ruleData.compiledSelector()) {
+            if (m_checker.pseudoStyle() != NOPSEUDO)
+                return false;
+            SelectorCompilerCheckingContext context(&m_checker, style(), m_parentNode ? m_parentNode->renderStyle() : 0);
+            return compiledSelector->matches(m_element, context);
+        }
+    }
+#endif
+
     // Slow path.
     SelectorChecker::SelectorCheckingContext context(ruleData.selector(), m_element, SelectorChecker::VisitedMatchEnabled);
     context.elementStyle = style();
@@ -2237,7 +2407,13 @@ RuleData::RuleData(CSSStyleRule* rule, CSSSelector* selector, unsigned position,
     : m_rule(rule)
     , m_selector(selector)
     , m_specificity(selector->specificity())
+#if ENABLE(CSS_SELECTOR_JIT)
+    , m_slowPathCheckCount(0)
+    , m_isCompilableSelector(false)
+#endif
     , m_position(position)
+    , m_hasDirectAdjacentSiblingSelector(false)
+    , m_hasIndirectAdjacentSiblingSelector(false)
     , m_hasFastCheckableSelector(canUseFastCheckSelector && SelectorChecker::isFastCheckableSelector(selector))
     , m_hasMultipartSelector(!!selector->tagHistory())
     , m_hasRightmostSelectorMatchingHTMLBasedOnRuleHash(isSelectorMatchingHTMLBasedOnRuleHash(selector))
@@ -2245,6 +2421,21 @@ RuleData::RuleData(CSSStyleRule* rule, CSSSelector* selector, unsigned position,
     , m_linkMatchType(SelectorChecker::determineLinkMatchType(selector))
 {
     SelectorChecker::collectIdentifierHashes(m_selector, m_descendantSelectorIdentifierHashes, maximumIdentifierCount);
+    SelectorChecker::collectSiblingIdentifierHashes(m_selector, m_siblingSelectorIdentifierHashes, maximumSiblingIdentifierCount);
+    m_subjectAttributeNameMask = SelectorChecker::subjectAttributeNameMask(m_selector);
+    for (const CSSSelector* siblingSelector = m_selector; siblingSelector; siblingSelector = siblingSelector->tagHistory()) {
+        CSSSelector::Relation relation = siblingSelector->relation();
+        if (relation == CSSSelector::DirectAdjacent)
+            m_hasDirectAdjacentSiblingSelector = true;
+        else if (relation == CSSSelector::IndirectAdjacent)
+            m_hasIndirectAdjacentSiblingSelector = true;
+        else if (relation != CSSSelector::SubSelector)
+            break;
+    }
+#if ENABLE(CSS_SELECTOR_JIT)
+    // Fast checkable selectors are about as quick without compiling them.
+    m_isCompilableSelector = canUseFastCheckSelector && !m_hasFastCheckableSelector && SelectorCompiler::canCompile(selector);
+#endif
 }
 
 RuleSet::RuleSet()
@@ -2276,6 +2467,81 @@ static inline void collectFeaturesFromSelector(CSSStyleSelector::Features& featu
     }
 }
 
+enum InvalidationScope { InvalidateSelf, InvalidateDescendants, InvalidateSubtree };
+
+static inline void collectInvalidationSetFromSelector(CSSStyleSelector::Features& features, const CSSSelector* selector, InvalidationScope scope, const CSSSelector* subjectFeature)
+{
+    StyleInvalidationSet* invalidationSet;
+    if (selector->m_match == CSSSelector::Id)
+        invalidationSet = &ensureInvalidationSet(features.idInvalidationSets, selector->value().impl());
+    else if (selector->m_match == CSSSelector::Class)
+        invalidationSet = &ensureInvalidationSet(features.classInvalidationSets, selector->value().impl());
+    else if (selector->isAttributeSelector())
+        invalidationSet = &ensureInvalidationSet(features.attributeInvalidationSets, selector->attribute().localName().impl());
+    else
+        return;
+
+    if (scope == InvalidateSelf)
+        invalidationSet->setInvalidatesSelf();
+    else if (scope == InvalidateSubtree || !subjectFeature)
+        invalidationSet->setInvalidatesSubtree();
+    else if (subjectFeature->m_match == CSSSelector::Id)
+        invalidationSet->addDescendantId(subjectFeature->value().impl());
+    else if (subjectFeature->m_match == CSSSelector::Class)
+        invalidationSet->addDescendantClass(subjectFeature->value().impl());
+    else
+        invalidationSet->addDescendantTagName(subjectFeature->tag().localName().impl());
+}
+
+// Returns the simple selector for an id, class or tag that every element matching the rightmost compound selector has.
+static const CSSSelector* subjectFeatureForInvalidation(const CSSSelector* selector)
+{
+    const CSSSelector* classSelector = 0;
+    const CSSSelector* tagSelector = 0;
+    for (; selector; selector = selector->tagHistory()) {
+        if (selector->m_match == CSSSelector::Id)
+            return selector;
+        if (selector->m_match == CSSSelector::Class && !classSelector)
+            classSelector = selector;
+        if (selector->hasTag() && selector->tag().localName() != starAtom && !tagSelector)
+            tagSelector = selector;
+        if (selector->relation() != CSSSelector::SubSelector)
+            break;
+    }
+    return classSelector ? classSelector : tagSelector;
+}
+
+static void collectInvalidationSetsFromRuleData(CSSStyleSelector::Features& features, const RuleData& ruleData)
+{
+    const CSSSelector* subjectFeature = subjectFeatureForInvalidation(ruleData.selector());
+    InvalidationScope scope = InvalidateSelf;
+    for (const CSSSelector* selector = ruleData.selector(); selector; selector = selector->tagHistory()) {
+        collectInvalidationSetFromSelector(features, selector, scope, subjectFeature);
+        if (CSSSelectorList* selectorList = selector->selectorList()) {
+            for (const CSSSelector* subSelector = selectorList->first(); subSelector; subSelector = CSSSelectorList::next(subSelector)) {
+                for (const CSSSelector* simpleSelector = subSelector; simpleSelector; simpleSelector = simpleSelector->tagHistory())
+                    collectInvalidationSetFromSelector(features, simpleSelector, scope, subjectFeature);
+            }
+        }
+
+        switch (selector->relation()) {
+        case CSSSelector::SubSelector:
+            break;
+        case CSSSelector::Descendant:
+        case CSSSelector::Child:
+            if (scope == InvalidateSelf)
+                scope = InvalidateDescendants;
+            break;
+        case CSSSelector::DirectAdjacent:
+        case CSSSelector::IndirectAdjacent:
+        case CSSSelector::ShadowDescendant:
+            // Element::recalcStyle() takes care of the siblings of elements with a full style change.
+            scope = InvalidateSubtree;
+            break;
+        }
+    }
+}
+
 static void collectFeaturesFromRuleData(CSSStyleSelector::Features& features, const RuleData& ruleData)
 {
     bool foundSiblingSelector = false;
@@ -2295,6 +2561,7 @@ static void collectFeaturesFromRuleData(CSSStyleSelector::Features& features, co
         features.siblingRules.append(CSSStyleSelector::RuleSelectorPair(ruleData.rule(), ruleData.selector()));
     if (ruleData.containsUncommonAttributeSelector())
         features.uncommonAttributeRules.append(CSSStyleSelector::RuleSelectorPair(ruleData.rule(), ruleData.selector()));
+    collectInvalidationSetsFromRuleData(features, ruleData);
 }
     
 void RuleSet::addToRuleSet(AtomicStringImpl* key, AtomRuleMap& map, const RuleData& ruleData)
@@ -2641,6 +2908,12 @@ const CSSStyleSelector::MatchedPropertiesCacheItem* CSSStyleSelector::findFromMa
     }
     if (cacheItem.ranges != matchResult.ranges)
         return 0;
+    // The saved user agent border and background are in terms of the zoom and font they were
+    // resolved with, which the same declarations only reproduce under an equivalent parent.
+    if (cacheItem.hasUAAppearance
+        && (m_parentStyle->effectiveZoom() != cacheItem.parentRenderStyle->effectiveZoom()
+            || m_parentStyle->fontDescription() != cacheItem.parentRenderStyle->fontDescription()))
+        return 0;
     return &cacheItem;
 }
 
@@ -2660,6 +2933,12 @@ void CSSStyleSelector::addToMatchedPropertiesCache(const RenderStyle* style, con
     // The RenderStyle in the cache is really just a holder for the substructures and never used as-is.
     cacheItem.renderStyle = RenderStyle::clone(style);
     cacheItem.parentRenderStyle = RenderStyle::clone(parentStyle);
+    cacheItem.hasUAAppearance = m_hasUAAppearance;
+    if (m_hasUAAppearance) {
+        cacheItem.borderData = m_borderData;
+        cacheItem.backgroundData = m_backgroundData;
+        cacheItem.backgroundColor = m_backgroundColor;
+    }
     m_matchedPropertiesCache.add(hash, cacheItem);
 }
 
@@ -2672,8 +2951,6 @@ static bool isCacheableInMatchedPropertiesCache(const RenderStyle* style, const
 {
     if (style->unique() || (style->styleType() != NOPSEUDO && parentStyle->unique()))
         return false;
-    if (style->hasAppearance())
-        return false;
     if (style->zoom() != RenderStyle::initialZoom())
         return false;
     // The cache assumes static knowledge about which properties are inherited.
@@ -2692,6 +2969,12 @@ void CSSStyleSelector::applyMatchedProperties(const MatchResult& matchResult)
         // style declarations. We then only need to apply the inherited properties, if any, as their values can depend on the 
         // element context. This is fast and saves memory by reusing the style data structures.
         m_style->copyNonInheritedFrom(cacheItem->renderStyle.get());
+        m_hasUAAppearance = cacheItem->hasUAAppearance;
+        if (m_hasUAAppearance) {
+            m_borderData = cacheItem->borderData;
+            m_backgroundData = cacheItem->backgroundData;
+            m_backgroundColor = cacheItem->backgroundColor;
+        }
         if (m_parentStyle->inheritedDataShared(cacheItem->parentRenderStyle.get())) {
             EInsideLink linkStatus = m_style->insideLink();
             // If the cache item parent style has identical inherited properties to the current parent style then the
@@ -2732,8 +3015,10 @@ void CSSStyleSelector::applyMatchedProperties(const MatchResult& matchResult)
     // Now do the normal priority UA properties.
     applyMatchedProperties<false>(matchResult, false, matchResult.ranges.firstUARule, matchResult.ranges.lastUARule, applyInheritedOnly);
     
-    // Cache our border and background so that we can examine them later.
-    cacheBorderAndBackground();
+    // Cache our border and background so that we can examine them later. On a cache hit
+    // the style already holds the author values, so the saved ones were restored above.
+    if (!cacheItem)
+        cacheBorderAndBackground();
     
     // Now do the author and user normal priority properties and all the !important properties.
     applyMatchedProperties<false>(matchResult, false, matchResult.ranges.lastUARule + 1, matchResult.matchedProperties.size() - 1, applyInheritedOnly);
@@ -3097,6 +3382,7 @@ void CSSStyleSelector::applyProperty(int id, CSSValue *value)
                 didSet = true;
                 // register the fact that the attribute value affects the style
                 m_features.attrsInRules.add(attr.localName().impl());
+                ensureInvalidationSet(m_features.attributeInvalidationSets, attr.localName().impl()).setInvalidatesSelf();
             } else if (contentValue->isURI()) {
                 if (!contentValue->isImageValue())
                     break;
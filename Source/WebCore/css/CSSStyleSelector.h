@@ -29,6 +29,7 @@
 #include "SelectorChecker.h"
 #include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
+#include <wtf/OwnPtr.h>
 #include <wtf/RefPtr.h>
 #include <wtf/Vector.h>
 #include <wtf/text/StringHash.h>
@@ -68,6 +69,7 @@ class RuleData;
 class RuleSet;
 class Settings;
 class StyleImage;
+class StyleInvalidationSet;
 class StylePendingImage;
 class StylePropertySet;
 class StyleShader;
@@ -193,6 +195,11 @@ public:
 
     bool hasSelectorForAttribute(const AtomicString&) const;
 
+    // What to restyle when an element gains or loses the class, id or attribute. Null if no selector depends on it.
+    const StyleInvalidationSet* classInvalidationSet(const AtomicString& className) const { return m_features.classInvalidationSets.get(className.impl()); }
+    const StyleInvalidationSet* idInvalidationSet(const AtomicString& id) const { return m_features.idInvalidationSets.get(id.impl()); }
+    const StyleInvalidationSet* attributeInvalidationSet(const AtomicString& localName) const { return m_features.attributeInvalidationSets.get(localName.impl()); }
+
     CSSFontSelector* fontSelector() const { return m_fontSelector.get(); }
 
     void addViewportDependentMediaQueryResult(const MediaQueryExp*, bool result);
@@ -239,6 +246,10 @@ public:
         void clear();
         HashSet<AtomicStringImpl*> idsInRules;
         HashSet<AtomicStringImpl*> attrsInRules;
+        typedef HashMap<AtomicStringImpl*, OwnPtr<StyleInvalidationSet> > InvalidationSetMap;
+        InvalidationSetMap classInvalidationSets;
+        InvalidationSetMap idInvalidationSets;
+        InvalidationSetMap attributeInvalidationSets;
         Vector<RuleSelectorPair> siblingRules;
         Vector<RuleSelectorPair> uncommonAttributeRules;
         bool usesFirstLineRules;
@@ -302,7 +313,8 @@ private:
     void collectMatchingRules(RuleSet*, int& firstRuleIndex, int& lastRuleIndex, const MatchOptions&);
     void collectMatchingRulesForRegion(RuleSet*, int& firstRuleIndex, int& lastRuleIndex, const MatchOptions&);
     void collectMatchingRulesForList(const Vector<RuleData>*, int& firstRuleIndex, int& lastRuleIndex, const MatchOptions&);
-    bool fastRejectSelector(const RuleData&) const;
+    bool fastRejectSelector(const RuleData&, bool canUseParentStack);
+    unsigned elementAttributeNameMask();
     void sortMatchedRules();
     void sortAndTransferMatchedRules(MatchResult&);
 
@@ -327,6 +339,7 @@ private:
     OwnPtr<RuleSet> m_userStyle;
 
     Features m_features;
+    unsigned m_featuresDefaultStyleGeneration;
     OwnPtr<RuleSet> m_siblingRuleSet;
     OwnPtr<RuleSet> m_uncommonAttributeRuleSet;
 
@@ -392,10 +405,20 @@ private:
 
     static unsigned computeMatchedPropertiesHash(const MatchedProperties*, unsigned size);
     struct MatchedPropertiesCacheItem {
+        MatchedPropertiesCacheItem()
+            : hasUAAppearance(false)
+            , backgroundData(BackgroundFillLayer)
+        {
+        }
         Vector<MatchedProperties> matchedProperties;
         MatchRanges ranges;
         RefPtr<RenderStyle> renderStyle;
         RefPtr<RenderStyle> parentRenderStyle;
+        // What cacheBorderAndBackground() saw, since a cache hit skips the point where it runs.
+        bool hasUAAppearance;
+        BorderData borderData;
+        FillLayer backgroundData;
+        Color backgroundColor;
     };
     const MatchedPropertiesCacheItem* findFromMatchedPropertiesCache(unsigned hash, const MatchResult&);
     void addToMatchedPropertiesCache(const RenderStyle*, const RenderStyle* parentStyle, unsigned hash, const MatchResult&);
@@ -436,6 +459,9 @@ private:
     bool m_fontDirty;
     bool m_matchAuthorAndUserStyles;
     bool m_sameOriginOnly;
+    // Lazily computed for the element being styled, see SelectorChecker::elementAttributeNameMask().
+    unsigned m_elementAttributeNameMask;
+    bool m_elementAttributeNameMaskIsValid;
 
     RefPtr<CSSFontSelector> m_fontSelector;
     Vector<OwnPtr<MediaQueryResult> > m_viewportDependentMediaQueryResults;
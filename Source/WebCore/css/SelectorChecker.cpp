@@ -155,6 +155,28 @@ void SelectorChecker::pushParent(Element* parent)
     pushParentStackFrame(parent);
 }
 
+void SelectorChecker::updateSiblingIdentifierFilter(ParentStackFrame& parentFrame, const Element* element)
+{
+    // Children are usually styled in document order, in which case only the siblings between the
+    // previously styled child and this one need to be added. Otherwise start over.
+    Element* sibling = element->previousElementSibling();
+    while (sibling && sibling != parentFrame.siblingFilterElement)
+        sibling = sibling->previousElementSibling();
+    Element* end = sibling ? sibling->previousElementSibling() : 0;
+    if (!sibling)
+        parentFrame.siblingIdentifierFilter.clear();
+
+    Vector<unsigned, 4> identifierHashes;
+    for (sibling = element->previousElementSibling(); sibling != end; sibling = sibling->previousElementSibling()) {
+        identifierHashes.shrink(0);
+        collectElementIdentifierHashes(sibling, identifierHashes);
+        size_t count = identifierHashes.size();
+        for (size_t i = 0; i < count; ++i)
+            parentFrame.siblingIdentifierFilter.add(identifierHashes[i]);
+    }
+    parentFrame.siblingFilterElement = element;
+}
+
 static inline void collectDescendantSelectorIdentifierHashes(const CSSSelector* selector, unsigned*& hash, const unsigned* end)
 {
     switch (selector->m_match) {
@@ -209,6 +231,69 @@ void SelectorChecker::collectIdentifierHashes(const CSSSelector* selector, unsig
     *hash = 0;
 }
 
+void SelectorChecker::collectSiblingIdentifierHashes(const CSSSelector* selector, unsigned* identifierHashes, unsigned maximumIdentifierCount)
+{
+    unsigned* hash = identifierHashes;
+    unsigned* end = identifierHashes + maximumIdentifierCount;
+    CSSSelector::Relation relation = selector->relation();
+
+    // Skip the topmost selector like collectIdentifierHashes() does, then only collect identifiers
+    // up to the first combinator that leaves the siblings of the element.
+    bool skipOverSubselectors = true;
+    for (selector = selector->tagHistory(); selector; selector = selector->tagHistory()) {
+        switch (relation) {
+        case CSSSelector::SubSelector:
+            if (!skipOverSubselectors)
+                collectDescendantSelectorIdentifierHashes(selector, hash, end);
+            break;
+        case CSSSelector::DirectAdjacent:
+        case CSSSelector::IndirectAdjacent:
+            skipOverSubselectors = false;
+            collectDescendantSelectorIdentifierHashes(selector, hash, end);
+            break;
+        case CSSSelector::Descendant:
+        case CSSSelector::Child:
+        case CSSSelector::ShadowDescendant:
+            *hash = 0;
+            return;
+        }
+        if (hash == end)
+            return;
+        relation = selector->relation();
+    }
+    *hash = 0;
+}
+
+static inline unsigned attributeNameMaskBit(const AtomicString& localName)
+{
+    return 1U << (localName.impl()->existingHash() & 31);
+}
+
+unsigned SelectorChecker::subjectAttributeNameMask(const CSSSelector* selector)
+{
+    // Attribute selectors inside :not() or behind a combinator do not need the element to have the attribute.
+    unsigned mask = 0;
+    for (; selector; selector = selector->tagHistory()) {
+        if (selector->isAttributeSelector())
+            mask |= attributeNameMaskBit(selector->attribute().localName());
+        if (selector->relation() != CSSSelector::SubSelector)
+            break;
+    }
+    return mask;
+}
+
+unsigned SelectorChecker::elementAttributeNameMask(Element* element)
+{
+    // hasAttributes() brings lazily synchronized attributes up to date, as checkOneSelector() relies on.
+    if (!element->hasAttributes())
+        return 0;
+    unsigned mask = 0;
+    size_t count = element->attributeCount();
+    for (size_t i = 0; i < count; ++i)
+        mask |= attributeNameMaskBit(element->attributeItem(i)->localName());
+    return mask;
+}
+
 static inline const AtomicString* linkAttribute(Node* node)
 {
     if (!node->isLink())
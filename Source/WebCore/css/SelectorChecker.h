@@ -82,6 +82,17 @@ public:
     inline bool fastRejectSelector(const unsigned* identifierHashes) const;
     static void collectIdentifierHashes(const CSSSelector*, unsigned* identifierHashes, unsigned maximumIdentifierCount);
 
+    // Rejects selectors whose sibling compound selectors cannot match any element sibling preceding the given one.
+    // The element must be a child of the parent on top of the parent stack.
+    template <unsigned maximumIdentifierCount>
+    inline bool fastRejectSiblingSelector(const Element*, const unsigned* identifierHashes);
+    static void collectSiblingIdentifierHashes(const CSSSelector*, unsigned* identifierHashes, unsigned maximumIdentifierCount);
+
+    // Attribute names are folded into one bit each of a 32 bit mask. An element can only match a selector
+    // if its mask has all the bits of the attribute selectors in the rightmost compound selector.
+    static unsigned subjectAttributeNameMask(const CSSSelector*);
+    static unsigned elementAttributeNameMask(Element*);
+
     void setupParentStack(Element* parent);
     void pushParent(Element* parent);
     void popParent() { popParentStackFrame(); }
@@ -118,6 +129,8 @@ public:
     static bool determineSelectorScopes(const CSSSelectorList&, HashSet<AtomicStringImpl*>& idScopes, HashSet<AtomicStringImpl*>& classScopes);
 
 private:
+    friend class SelectorCompiler;
+
     bool checkOneSelector(const SelectorCheckingContext&, PseudoId&) const;
     bool checkScrollbarPseudoClass(CSSSelector*, PseudoId& dynamicPseudo) const;
     static bool isFrameFocused(const Element*);
@@ -138,14 +151,22 @@ private:
     mutable bool m_hasUnknownPseudoElements;
     mutable HashSet<LinkHash, LinkHashHash> m_linksCheckedForVisitedState;
 
+    // Siblings are few and mostly share their identifiers, so a small table is enough.
+    static const unsigned siblingFilterKeyBits = 8;
+
     struct ParentStackFrame {
-        ParentStackFrame() : element(0) { }
-        ParentStackFrame(Element* element) : element(element) { }
+        ParentStackFrame() : element(0), siblingFilterElement(0) { }
+        ParentStackFrame(Element* element) : element(element), siblingFilterElement(0) { }
         Element* element;
         Vector<unsigned, 4> identifierHashes;
+        // The child whose preceding element siblings are in siblingIdentifierFilter.
+        const Element* siblingFilterElement;
+        BloomFilter<siblingFilterKeyBits> siblingIdentifierFilter;
     };
     Vector<ParentStackFrame> m_parentStack;
 
+    static void updateSiblingIdentifierFilter(ParentStackFrame&, const Element*);
+
     // With 100 unique strings in the filter, 2^12 slot table has false positive rate of ~0.2%.
     static const unsigned bloomFilterKeyBits = 12;
     OwnPtr<BloomFilter<bloomFilterKeyBits> > m_ancestorIdentifierFilter;
@@ -169,6 +190,20 @@ inline bool SelectorChecker::fastRejectSelector(const unsigned* identifierHashes
     return false;
 }
 
+template <unsigned maximumIdentifierCount>
+inline bool SelectorChecker::fastRejectSiblingSelector(const Element* element, const unsigned* identifierHashes)
+{
+    ASSERT(!m_parentStack.isEmpty());
+    ParentStackFrame& parentFrame = m_parentStack.last();
+    if (parentFrame.siblingFilterElement != element)
+        updateSiblingIdentifierFilter(parentFrame, element);
+    for (unsigned n = 0; n < maximumIdentifierCount && identifierHashes[n]; ++n) {
+        if (!parentFrame.siblingIdentifierFilter.mayContain(identifierHashes[n]))
+            return true;
+    }
+    return false;
+}
+
 inline bool SelectorChecker::isCommonPseudoClassSelector(const CSSSelector* selector)
 {
     if (selector->m_match != CSSSelector::PseudoClass)
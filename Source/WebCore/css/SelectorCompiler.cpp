@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SelectorCompiler.h"
+
+#if ENABLE(CSS_SELECTOR_JIT)
+
+#include "CSSSelector.h"
+#include "CSSSelectorList.h"
+#include "Element.h"
+#include "JSDOMWindowBase.h"
+#include "QualifiedName.h"
+#include "SelectorChecker.h"
+#include "StyledElement.h"
+#include <assembler/LinkBuffer.h>
+#include <assembler/MacroAssembler.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+using namespace JSC;
+
+// The element, the element to backtrack to and the context must survive the calls out of the
+// generated code, so they live in callee-saved registers.
+static const MacroAssembler::RegisterID elementRegister = X86Registers::ebx;
+static const MacroAssembler::RegisterID backtrackingElementRegister = X86Registers::r12;
+static const MacroAssembler::RegisterID contextRegister = X86Registers::r13;
+static const MacroAssembler::RegisterID temporaryRegister = X86Registers::eax;
+static const MacroAssembler::RegisterID returnValueRegister = X86Registers::eax;
+static const MacroAssembler::RegisterID argumentRegister0 = X86Registers::edi;
+static const MacroAssembler::RegisterID argumentRegister1 = X86Registers::esi;
+static const MacroAssembler::RegisterID argumentRegister2 = X86Registers::edx;
+
+// Tag names are compared by the AtomicStringImpl pointer that is the whole of an AtomicString.
+COMPILE_ASSERT(sizeof(AtomicString) == sizeof(AtomicStringImpl*), AtomicString_should_be_a_single_pointer);
+
+static inline bool isCompilableRelation(CSSSelector::Relation relation)
+{
+    return relation == CSSSelector::Descendant || relation == CSSSelector::Child || relation == CSSSelector::SubSelector;
+}
+
+static bool isCompilableSimpleSelector(const CSSSelector* selector)
+{
+    switch (selector->m_match) {
+    case CSSSelector::None:
+    case CSSSelector::Id:
+    case CSSSelector::Class:
+    case CSSSelector::Exact:
+    case CSSSelector::Set:
+    case CSSSelector::List:
+    case CSSSelector::Hyphen:
+    case CSSSelector::Contain:
+    case CSSSelector::Begin:
+    case CSSSelector::End:
+        return true;
+    case CSSSelector::PseudoClass:
+        break;
+    default:
+        return false;
+    }
+
+    switch (selector->pseudoType()) {
+    case CSSSelector::PseudoUnknown:
+    // :link and :visited depend on the visited match type, which the compiled code does not track.
+    case CSSSelector::PseudoLink:
+    case CSSSelector::PseudoVisited:
+    // :-webkit-any() matches whole selectors recursively.
+    case CSSSelector::PseudoAny:
+        return false;
+    case CSSSelector::PseudoNot:
+        ASSERT(selector->selectorList());
+        for (const CSSSelector* subSelector = selector->selectorList()->first(); subSelector; subSelector = subSelector->tagHistory()) {
+            if (subSelector->pseudoType() == CSSSelector::PseudoLink || subSelector->pseudoType() == CSSSelector::PseudoVisited)
+                return false;
+        }
+        return true;
+    default:
+        return true;
+    }
+}
+
+bool SelectorCompiler::canCompile(const CSSSelector* selector)
+{
+    for (; selector; selector = selector->tagHistory()) {
+        if (selector->tagHistory() && !isCompilableRelation(selector->relation()))
+            return false;
+        if (!isCompilableSimpleSelector(selector))
+            return false;
+    }
+    return true;
+}
+
+bool SelectorCompiler::idMatches(Element* element, const SelectorCompilerCheckingContext*, CSSSelector* selector)
+{
+    return element->idForStyleResolution().impl() == selector->value().impl();
+}
+
+bool SelectorCompiler::classMatches(Element* element, const SelectorCompilerCheckingContext*, CSSSelector* selector)
+{
+    return static_cast<StyledElement*>(element)->classNames().contains(selector->value());
+}
+
+template <bool isSubjectElement, bool isSubSelector>
+bool SelectorCompiler::checkOneSelector(Element* element, const SelectorCompilerCheckingContext* context, CSSSelector* selector)
+{
+    SelectorChecker::SelectorCheckingContext selectorContext(selector, element, SelectorChecker::VisitedMatchDisabled);
+    // Only the styled element has its new style at hand; pseudo classes update the current style of ancestors.
+    if (isSubjectElement) {
+        selectorContext.elementStyle = context->elementStyle;
+        selectorContext.elementParentStyle = context->elementParentStyle;
+    }
+    selectorContext.isSubSelector = isSubSelector;
+    PseudoId dynamicPseudo = NOPSEUDO;
+    return context->checker->checkOneSelector(selectorContext, dynamicPseudo);
+}
+
+// The simple selectors that one element has to match, and how that element relates to the one matched
+// before it.
+struct SelectorFragment {
+    SelectorFragment(CSSSelector::Relation relationToRightFragment)
+        : relationToRightFragment(relationToRightFragment)
+    {
+    }
+
+    CSSSelector::Relation relationToRightFragment;
+    Vector<CSSSelector*, 4> simpleSelectors;
+};
+
+class SelectorCodeGenerator {
+    WTF_MAKE_NONCOPYABLE(SelectorCodeGenerator);
+public:
+    explicit SelectorCodeGenerator(CSSSelector*);
+
+    PassRefPtr<CompiledSelector> compile(JSGlobalData&);
+
+private:
+    void generateWalkToParentElement(MacroAssembler::JumpList& failureCases);
+    void generateFragmentMatching(const SelectorFragment&, bool isSubjectFragment, MacroAssembler::JumpList& failureCases);
+    void generateTagCheck(const CSSSelector*, MacroAssembler::JumpList& failureCases);
+    void generateFlagCheck(uint32_t flag, MacroAssembler::JumpList& failureCases);
+    void generateFunctionCall(FunctionPtr, CSSSelector*, MacroAssembler::JumpList& failureCases);
+
+    CSSSelector* m_selector;
+    Vector<SelectorFragment, 8> m_fragments;
+    MacroAssembler m_assembler;
+    Vector<std::pair<MacroAssembler::Call, FunctionPtr> > m_functionCalls;
+};
+
+SelectorCodeGenerator::SelectorCodeGenerator(CSSSelector* selector)
+    : m_selector(selector)
+{
+    m_fragments.append(SelectorFragment(CSSSelector::SubSelector));
+    for (; selector; selector = selector->tagHistory()) {
+        m_fragments.last().simpleSelectors.append(selector);
+        if (selector->tagHistory() && selector->relation() != CSSSelector::SubSelector)
+            m_fragments.append(SelectorFragment(selector->relation()));
+    }
+}
+
+PassRefPtr<CompiledSelector> SelectorCodeGenerator::compile(JSGlobalData& globalData)
+{
+    // Three pushes leave the stack 16 byte aligned for the calls out.
+    m_assembler.push(elementRegister);
+    m_assembler.push(backtrackingElementRegister);
+    m_assembler.push(contextRegister);
+    m_assembler.move(argumentRegister0, elementRegister);
+    m_assembler.move(argumentRegister1, contextRegister);
+
+    MacroAssembler::JumpList failureCases;
+    generateFragmentMatching(m_fragments[0], true, failureCases);
+
+    // This walks the ancestors the same way SelectorChecker::fastCheckSelector() does. The fragments
+    // between two descendant combinators have to match consecutive ancestors; when one of them fails,
+    // matching resumes above the element that the closest descendant combinator's fragment matched.
+    MacroAssembler::Label descendantBacktrackingStart;
+    bool hasDescendantBacktrackingStart = false;
+    for (size_t i = 1; i < m_fragments.size(); ++i) {
+        const SelectorFragment& fragment = m_fragments[i];
+
+        if (fragment.relationToRightFragment == CSSSelector::Descendant) {
+            MacroAssembler::Label loopStart = m_assembler.label();
+            generateWalkToParentElement(failureCases);
+            MacroAssembler::JumpList notMatchingAncestor;
+            generateFragmentMatching(fragment, false, notMatchingAncestor);
+            notMatchingAncestor.linkTo(loopStart, &m_assembler);
+
+            m_assembler.move(elementRegister, backtrackingElementRegister);
+            descendantBacktrackingStart = loopStart;
+            hasDescendantBacktrackingStart = true;
+            continue;
+        }
+
+        ASSERT(fragment.relationToRightFragment == CSSSelector::Child);
+        generateWalkToParentElement(failureCases);
+        if (!hasDescendantBacktrackingStart) {
+            generateFragmentMatching(fragment, false, failureCases);
+            continue;
+        }
+
+        MacroAssembler::JumpList notMatchingParent;
+        generateFragmentMatching(fragment, false, notMatchingParent);
+        MacroAssembler::Jump matchingParent = m_assembler.jump();
+        notMatchingParent.link(&m_assembler);
+        m_assembler.move(backtrackingElementRegister, elementRegister);
+        m_assembler.jump().linkTo(descendantBacktrackingStart, &m_assembler);
+        matchingParent.link(&m_assembler);
+    }
+
+    m_assembler.move(MacroAssembler::TrustedImm32(1), returnValueRegister);
+    MacroAssembler::Jump done = m_assembler.jump();
+    failureCases.link(&m_assembler);
+    m_assembler.move(MacroAssembler::TrustedImm32(0), returnValueRegister);
+    done.link(&m_assembler);
+
+    m_assembler.pop(contextRegister);
+    m_assembler.pop(backtrackingElementRegister);
+    m_assembler.pop(elementRegister);
+    m_assembler.ret();
+
+    // The executable pool is shared with JavaScript; when it is full, the rule keeps using SelectorChecker.
+    LinkBuffer linkBuffer(globalData, &m_assembler, m_selector, JITCompilationCanFail);
+    if (linkBuffer.didFailToAllocate())
+        return 0;
+    for (size_t i = 0; i < m_functionCalls.size(); ++i)
+        linkBuffer.link(m_functionCalls[i].first, m_functionCalls[i].second);
+    return CompiledSelector::create(linkBuffer.finalizeCode());
+}
+
+void SelectorCodeGenerator::generateWalkToParentElement(MacroAssembler::JumpList& failureCases)
+{
+    // This is Node::parentElement(). The current element is never a shadow root, so its parent is the
+    // parent node. Running out of ancestors means that no other ancestor can match either.
+    m_assembler.loadPtr(MacroAssembler::Address(elementRegister, Node::parentMemoryOffset()), elementRegister);
+    failureCases.append(m_assembler.branchTestPtr(MacroAssembler::Zero, elementRegister));
+    failureCases.append(m_assembler.branchTest32(MacroAssembler::Zero, MacroAssembler::Address(elementRegister, Node::nodeFlagsMemoryOffset()), MacroAssembler::TrustedImm32(Node::flagIsElement())));
+
+    // An element that is a shadow root is the root of an SVG <use> tree, which CSS selectors do not
+    // apply to; see SelectorChecker::checkSelector().
+    failureCases.append(m_assembler.branchTest32(MacroAssembler::NonZero, MacroAssembler::Address(elementRegister, Node::nodeFlagsMemoryOffset()), MacroAssembler::TrustedImm32(Node::flagIsShadowRootOrSVGShadowRoot())));
+}
+
+void SelectorCodeGenerator::generateFragmentMatching(const SelectorFragment& fragment, bool isSubjectFragment, MacroAssembler::JumpList& failureCases)
+{
+    for (size_t i = 0; i < fragment.simpleSelectors.size(); ++i) {
+        CSSSelector* selector = fragment.simpleSelectors[i];
+        bool isSubSelector = i;
+
+        generateTagCheck(selector, failureCases);
+
+        switch (selector->m_match) {
+        case CSSSelector::None:
+            break;
+        case CSSSelector::Id:
+            generateFlagCheck(Node::flagHasID(), failureCases);
+            generateFunctionCall(SelectorCompiler::idMatches, selector, failureCases);
+            break;
+        case CSSSelector::Class:
+            generateFlagCheck(Node::flagHasClass(), failureCases);
+            generateFunctionCall(SelectorCompiler::classMatches, selector, failureCases);
+            break;
+        default:
+            if (isSubjectFragment)
+                generateFunctionCall(isSubSelector ? SelectorCompiler::checkOneSelector<true, true> : SelectorCompiler::checkOneSelector<true, false>, selector, failureCases);
+            else
+                generateFunctionCall(isSubSelector ? SelectorCompiler::checkOneSelector<false, true> : SelectorCompiler::checkOneSelector<false, false>, selector, failureCases);
+            break;
+        }
+    }
+}
+
+void SelectorCodeGenerator::generateTagCheck(const CSSSelector* selector, MacroAssembler::JumpList& failureCases)
+{
+    // This is SelectorChecker::tagMatches().
+    if (!selector->hasTag())
+        return;
+    const AtomicString& localName = selector->tag().localName();
+    const AtomicString& namespaceURI = selector->tag().namespaceURI();
+    if (localName == starAtom && namespaceURI == starAtom)
+        return;
+
+    m_assembler.loadPtr(MacroAssembler::Address(elementRegister, Element::tagQNameMemoryOffset() + QualifiedName::implMemoryOffset()), temporaryRegister);
+    if (localName != starAtom)
+        failureCases.append(m_assembler.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(temporaryRegister, QualifiedName::QualifiedNameImpl::localNameMemoryOffset()), MacroAssembler::TrustedImmPtr(localName.impl())));
+    if (namespaceURI != starAtom)
+        failureCases.append(m_assembler.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(temporaryRegister, QualifiedName::QualifiedNameImpl::namespaceMemoryOffset()), MacroAssembler::TrustedImmPtr(namespaceURI.impl())));
+}
+
+void SelectorCodeGenerator::generateFlagCheck(uint32_t flag, MacroAssembler::JumpList& failureCases)
+{
+    failureCases.append(m_assembler.branchTest32(MacroAssembler::Zero, MacroAssembler::Address(elementRegister, Node::nodeFlagsMemoryOffset()), MacroAssembler::TrustedImm32(flag)));
+}
+
+void SelectorCodeGenerator::generateFunctionCall(FunctionPtr function, CSSSelector* selector, MacroAssembler::JumpList& failureCases)
+{
+    m_assembler.move(elementRegister, argumentRegister0);
+    m_assembler.move(contextRegister, argumentRegister1);
+    m_assembler.move(MacroAssembler::TrustedImmPtr(selector), argumentRegister2);
+    m_functionCalls.append(std::make_pair(m_assembler.call(), function));
+
+    // The functions return bool, which only defines the low byte of the return value register.
+    failureCases.append(m_assembler.branchTest32(MacroAssembler::Zero, returnValueRegister, MacroAssembler::TrustedImm32(0xff)));
+}
+
+PassRefPtr<CompiledSelector> SelectorCompiler::compile(CSSSelector* selector)
+{
+    ASSERT(canCompile(selector));
+
+    JSGlobalData* globalData = JSDOMWindowBase::commonJSGlobalData();
+    if (!globalData->canUseJIT())
+        return 0;
+
+    SelectorCodeGenerator generator(selector);
+    return generator.compile(*globalData);
+}
+
+} // namespace WebCore
+
+#endif // ENABLE(CSS_SELECTOR_JIT)
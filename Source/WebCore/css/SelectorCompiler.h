@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SelectorCompiler_h
+#define SelectorCompiler_h
+
+#if ENABLE(CSS_SELECTOR_JIT)
+
+#include <assembler/MacroAssemblerCodeRef.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefCounted.h>
+
+namespace WebCore {
+
+class CSSSelector;
+class Element;
+class RenderStyle;
+class SelectorChecker;
+
+// What the compiled code needs to know about the element being styled, beyond the element itself.
+struct SelectorCompilerCheckingContext {
+    SelectorCompilerCheckingContext(const SelectorChecker* checker, RenderStyle* elementStyle, RenderStyle* elementParentStyle)
+        : checker(checker)
+        , elementStyle(elementStyle)
+        , elementParentStyle(elementParentStyle)
+    { }
+
+    const SelectorChecker* checker;
+    RenderStyle* elementStyle;
+    RenderStyle* elementParentStyle;
+};
+
+class CompiledSelector : public RefCounted<CompiledSelector> {
+public:
+    static PassRefPtr<CompiledSelector> create(const JSC::MacroAssemblerCodeRef& code)
+    {
+        return adoptRef(new CompiledSelector(code));
+    }
+
+    bool matches(Element* element, const SelectorCompilerCheckingContext& context) const
+    {
+        return reinterpret_cast<MatchFunction>(m_code.code().executableAddress())(element, &context);
+    }
+
+private:
+    typedef unsigned (*MatchFunction)(Element*, const SelectorCompilerCheckingContext*);
+
+    explicit CompiledSelector(const JSC::MacroAssemblerCodeRef& code)
+        : m_code(code)
+    {
+    }
+
+    JSC::MacroAssemblerCodeRef m_code;
+};
+
+// Turns a selector into native code that gives the same answer as SelectorChecker::checkSelector() for
+// the styled element, without pseudo elements, :visited handling or a scope. Only descendant, child and
+// subselector combinators are compiled. The walk up the ancestors and tag, id and class checks are done
+// inline; attribute selectors and pseudo classes such as :nth-child() call back into SelectorChecker.
+class SelectorCompiler {
+public:
+    static bool canCompile(const CSSSelector*);
+    // Returns 0 when native code cannot be generated.
+    static PassRefPtr<CompiledSelector> compile(CSSSelector*);
+
+private:
+    friend class SelectorCodeGenerator;
+
+    static bool idMatches(Element*, const SelectorCompilerCheckingContext*, CSSSelector*);
+    static bool classMatches(Element*, const SelectorCompilerCheckingContext*, CSSSelector*);
+    template <bool isSubjectElement, bool isSubSelector>
+    static bool checkOneSelector(Element*, const SelectorCompilerCheckingContext*, CSSSelector*);
+};
+
+} // namespace WebCore
+
+#endif // ENABLE(CSS_SELECTOR_JIT)
+
+#endif // SelectorCompiler_h
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StyleInvalidationSet.h"
+
+#include "Element.h"
+#include "StyledElement.h"
+
+namespace WebCore {
+
+static inline void addAll(HashSet<AtomicStringImpl*>& to, const HashSet<AtomicStringImpl*>& from)
+{
+    HashSet<AtomicStringImpl*>::const_iterator end = from.end();
+    for (HashSet<AtomicStringImpl*>::const_iterator it = from.begin(); it != end; ++it)
+        to.add(*it);
+}
+
+void StyleInvalidationSet::add(const StyleInvalidationSet& other)
+{
+    m_invalidatesSelf = m_invalidatesSelf || other.m_invalidatesSelf;
+    m_invalidatesSubtree = m_invalidatesSubtree || other.m_invalidatesSubtree;
+    addAll(m_descendantIds, other.m_descendantIds);
+    addAll(m_descendantClasses, other.m_descendantClasses);
+    addAll(m_descendantTagNames, other.m_descendantTagNames);
+}
+
+bool StyleInvalidationSet::invalidatesDescendant(Element* element) const
+{
+    if (m_descendantTagNames.contains(element->localName().impl()))
+        return true;
+    if (element->hasID() && m_descendantIds.contains(element->idForStyleResolution().impl()))
+        return true;
+    if (element->hasClass() && !m_descendantClasses.isEmpty()) {
+        const SpaceSplitString& classNames = static_cast<StyledElement*>(element)->classNames();
+        size_t count = classNames.size();
+        for (size_t i = 0; i < count; ++i) {
+            if (m_descendantClasses.contains(classNames[i].impl()))
+                return true;
+        }
+    }
+    return false;
+}
+
+void StyleInvalidationSet::invalidate(Element* element) const
+{
+    if (!element->attached())
+        return;
+
+    // A full style change also forces the descendants, and the siblings covered by the parent's adjacent rules flags, to be restyled.
+    if (m_invalidatesSubtree) {
+        element->setNeedsStyleRecalc();
+        return;
+    }
+
+    // InlineStyleChange restyles an element without forcing its descendants to be restyled as well.
+    if (m_invalidatesSelf)
+        element->setNeedsStyleRecalc(InlineStyleChange);
+
+    // A full style change restyles the whole subtree anyway.
+    if (!hasDescendantFeatures() || element->styleChangeType() >= FullStyleChange || !element->hasChildNodes())
+        return;
+
+    // Walking the subtree on every mutation would make a script that toggles classes in a loop quadratic.
+    element->addPendingStyleInvalidation(*this);
+}
+
+void StyleInvalidationSet::invalidateDescendants(Element* element) const
+{
+    if (!hasDescendantFeatures())
+        return;
+
+    // Descendant and child combinators do not cross into shadow trees, so only the children need to be walked.
+    Node* node = element->firstChild();
+    while (node) {
+        if (!node->isElementNode()) {
+            node = node->traverseNextNode(element);
+            continue;
+        }
+        Element* descendant = toElement(node);
+        if (descendant->styleChangeType() >= FullStyleChange) {
+            node = node->traverseNextSibling(element);
+            continue;
+        }
+        if (invalidatesDescendant(descendant))
+            descendant->setNeedsStyleRecalc(InlineStyleChange);
+        node = node->traverseNextNode(element);
+    }
+}
+
+} // namespace WebCore
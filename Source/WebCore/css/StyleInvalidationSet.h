@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 The Libre-Impuestos-WebKit Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef StyleInvalidationSet_h
+#define StyleInvalidationSet_h
+
+#include <wtf/FastAllocBase.h>
+#include <wtf/HashSet.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/text/AtomicStringImpl.h>
+
+namespace WebCore {
+
+class Element;
+
+// The elements whose style can change when an element gains or loses a given class, id or attribute.
+// RuleSet builds one per class, id and attribute name its selectors use.
+class StyleInvalidationSet {
+    WTF_MAKE_NONCOPYABLE(StyleInvalidationSet); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static PassOwnPtr<StyleInvalidationSet> create() { return adoptPtr(new StyleInvalidationSet); }
+
+    // The feature appears in the rightmost compound selector.
+    void setInvalidatesSelf() { m_invalidatesSelf = true; }
+    // The feature appears left of a sibling or shadow combinator, or left of a descendant or child
+    // combinator whose rightmost compound selector has no id, class or tag to look for.
+    void setInvalidatesSubtree() { m_invalidatesSubtree = true; }
+    // The feature appears left of a descendant or child combinator whose rightmost compound selector
+    // only matches elements with this id, class or tag.
+    void addDescendantId(AtomicStringImpl* id) { m_descendantIds.add(id); }
+    void addDescendantClass(AtomicStringImpl* className) { m_descendantClasses.add(className); }
+    void addDescendantTagName(AtomicStringImpl* localName) { m_descendantTagNames.add(localName); }
+
+    void add(const StyleInvalidationSet&);
+
+    // Marks the element for a style recalc if it is affected itself; descendants
+    // are looked for during that recalc, see Element::addPendingStyleInvalidation.
+    void invalidate(Element*) const;
+    void invalidateDescendants(Element*) const;
+
+private:
+    StyleInvalidationSet()
+        : m_invalidatesSelf(false)
+        , m_invalidatesSubtree(false)
+    {
+    }
+
+    bool hasDescendantFeatures() const { return !m_descendantIds.isEmpty() || !m_descendantClasses.isEmpty() || !m_descendantTagNames.isEmpty(); }
+    bool invalidatesDescendant(Element*) const;
+
+    bool m_invalidatesSelf;
+    bool m_invalidatesSubtree;
+    HashSet<AtomicStringImpl*> m_descendantIds;
+    HashSet<AtomicStringImpl*> m_descendantClasses;
+    HashSet<AtomicStringImpl*> m_descendantTagNames;
+};
+
+} // namespace WebCore
+
+#endif // StyleInvalidationSet_h
@@ -213,32 +213,43 @@ bool StyleAttributeMutationScope::s_shouldDeliver = false;
 StylePropertySet::StylePropertySet()
     : m_strictParsing(false)
     , m_hasCSSOMWrapper(false)
+    , m_isMutable(true)
+    , m_arraySize(0)
     , m_contextStyleSheet(0)
+    , m_mutablePropertyVector(adoptPtr(new Vector<CSSProperty, 4>))
 {
 }
 
 StylePropertySet::StylePropertySet(const Vector<CSSProperty>& properties)
-    : m_properties(properties)
-    , m_strictParsing(true)
+    : m_strictParsing(true)
     , m_hasCSSOMWrapper(false)
+    , m_isMutable(true)
+    , m_arraySize(0)
     , m_contextStyleSheet(0)
+    , m_mutablePropertyVector(adoptPtr(new Vector<CSSProperty, 4>(properties)))
 {
-    m_properties.shrinkToFit();
+    m_mutablePropertyVector->shrinkToFit();
 }
 
 StylePropertySet::StylePropertySet(CSSStyleSheet* contextStyleSheet)
     : m_strictParsing(!contextStyleSheet || contextStyleSheet->useStrictParsing())
     , m_hasCSSOMWrapper(false)
+    , m_isMutable(true)
+    , m_arraySize(0)
     , m_contextStyleSheet(contextStyleSheet)
+    , m_mutablePropertyVector(adoptPtr(new Vector<CSSProperty, 4>))
 {
 }
 
 StylePropertySet::StylePropertySet(CSSStyleSheet* contextStyleSheet, const CSSProperty* const * properties, int numProperties)
     : m_strictParsing(!contextStyleSheet || contextStyleSheet->useStrictParsing())
     , m_hasCSSOMWrapper(false)
+    , m_isMutable(true)
+    , m_arraySize(0)
     , m_contextStyleSheet(contextStyleSheet)
+    , m_mutablePropertyVector(adoptPtr(new Vector<CSSProperty, 4>))
 {
-    m_properties.reserveInitialCapacity(numProperties);
+    m_mutablePropertyVector->reserveInitialCapacity(numProperties);
     HashMap<int, bool> candidates;
     for (int i = 0; i < numProperties; ++i) {
         const CSSProperty *property = properties[i];
@@ -252,21 +263,81 @@ StylePropertySet::StylePropertySet(CSSStyleSheet* contextStyleSheet, const CSSPr
             removeProperty(property->id());
         }
 
-        m_properties.append(*property);
+        m_mutablePropertyVector->append(*property);
         candidates.set(property->id(), important);
     }
 }
 
+// The caller allocates room for the properties right after the set, see createImmutable().
+StylePropertySet::StylePropertySet(CSSStyleSheet* contextStyleSheet, bool strictParsing, const CSSProperty* const* properties, unsigned numProperties)
+    : m_strictParsing(strictParsing)
+    , m_hasCSSOMWrapper(false)
+    , m_isMutable(false)
+    , m_arraySize(numProperties)
+    , m_contextStyleSheet(contextStyleSheet)
+{
+    CSSProperty* array = immutablePropertyArray();
+    for (unsigned i = 0; i < numProperties; ++i)
+        new (&array[i]) CSSProperty(*properties[i]);
+}
+
+PassRefPtr<StylePropertySet> StylePropertySet::createImmutable(CSSStyleSheet* contextStyleSheet, bool strictParsing, const CSSProperty* const* properties, unsigned numProperties)
+{
+    void* slot = fastMalloc(sizeof(StylePropertySet) + sizeof(CSSProperty) * numProperties);
+    return adoptRef(new (slot) StylePropertySet(contextStyleSheet, strictParsing, properties, numProperties));
+}
+
+PassRefPtr<StylePropertySet> StylePropertySet::createImmutable(CSSStyleSheet* contextStyleSheet, const CSSProperty* const* properties, int numProperties)
+{
+    HashSet<int> seenProperties;
+    for (int i = 0; i < numProperties; ++i) {
+        if (!seenProperties.add(properties[i]->id()).second) {
+            // Let the mutable set decide which of the repeated declarations win.
+            RefPtr<StylePropertySet> propertySet = adoptRef(new StylePropertySet(contextStyleSheet, properties, numProperties));
+            return propertySet->immutableCopy();
+        }
+    }
+    return createImmutable(contextStyleSheet, !contextStyleSheet || contextStyleSheet->useStrictParsing(), properties, numProperties);
+}
+
 StylePropertySet::~StylePropertySet()
 {
     ASSERT(!m_hasCSSOMWrapper || propertySetCSSOMWrapperMap().contains(this));
     if (m_hasCSSOMWrapper)
         propertySetCSSOMWrapperMap().remove(this);
+
+    CSSProperty* array = immutablePropertyArray();
+    for (unsigned i = 0; i < m_arraySize; ++i)
+        array[i].~CSSProperty();
+}
+
+Vector<CSSProperty, 4>& StylePropertySet::mutablePropertyVector()
+{
+    if (!m_isMutable) {
+        // Move the properties out of the immutable array. Its memory is only released with the set,
+        // but the set keeps its identity, so CSSOM wrappers and style rules pointing to it stay valid.
+        OwnPtr<Vector<CSSProperty, 4> > properties = adoptPtr(new Vector<CSSProperty, 4>);
+        properties->reserveInitialCapacity(m_arraySize);
+        CSSProperty* array = immutablePropertyArray();
+        for (unsigned i = 0; i < m_arraySize; ++i) {
+            properties->uncheckedAppend(array[i]);
+            array[i].~CSSProperty();
+        }
+        m_arraySize = 0;
+        m_mutablePropertyVector = properties.release();
+        m_isMutable = true;
+    }
+    return *m_mutablePropertyVector;
 }
 
 void StylePropertySet::copyPropertiesFrom(const StylePropertySet& other)
 {
-    m_properties = other.m_properties;
+    Vector<CSSProperty, 4>& properties = mutablePropertyVector();
+    properties.clear();
+    unsigned size = other.propertyCount();
+    properties.reserveCapacity(size);
+    for (unsigned i = 0; i < size; ++i)
+        properties.uncheckedAppend(other.propertyAt(i));
 }
 
 String StylePropertySet::getPropertyValue(int propertyID) const
@@ -711,7 +782,8 @@ bool StylePropertySet::removeProperty(int propertyID, String* returnText)
 
     // A more efficient removal strategy would involve marking entries as empty
     // and sweeping them when the vector grows too big.
-    m_properties.remove(foundProperty - m_properties.data());
+    Vector<CSSProperty, 4>& properties = mutablePropertyVector();
+    properties.remove(foundProperty - properties.data());
     
     return true;
 }
@@ -768,7 +840,7 @@ void StylePropertySet::setProperty(const CSSProperty& property, CSSProperty* slo
             return;
         }
     }
-    m_properties.append(property);
+    mutablePropertyVector().append(property);
 }
 
 bool StylePropertySet::setProperty(int propertyID, int identifier, bool important)
@@ -792,14 +864,14 @@ bool StylePropertySet::setProperty(int propertyID, double value, CSSPrimitiveVal
 
 void StylePropertySet::parseDeclaration(const String& styleDeclaration)
 {
-    m_properties.clear();
+    mutablePropertyVector().clear();
     CSSParser parser(useStrictParsing());
     parser.parseDeclaration(this, styleDeclaration);
 }
 
 void StylePropertySet::addParsedProperties(const CSSProperty* const* properties, int numProperties)
 {
-    m_properties.reserveCapacity(numProperties);
+    mutablePropertyVector().reserveCapacity(numProperties);
     for (int i = 0; i < numProperties; ++i)
         addParsedProperty(*properties[i]);
 }
@@ -809,7 +881,7 @@ void StylePropertySet::addParsedProperty(const CSSProperty& property)
     // Only add properties that have no !important counterpart present
     if (!propertyIsImportant(property.id()) || property.isImportant()) {
         removeProperty(property.id());
-        m_properties.append(property);
+        mutablePropertyVector().append(property);
     }
 }
 
@@ -822,9 +894,9 @@ String StylePropertySet::asText() const
     const CSSProperty* repeatXProp = 0;
     const CSSProperty* repeatYProp = 0;
 
-    unsigned size = m_properties.size();
+    unsigned size = propertyCount();
     for (unsigned n = 0; n < size; ++n) {
-        const CSSProperty& prop = m_properties[n];
+        const CSSProperty& prop = propertyAt(n);
         if (prop.id() == CSSPropertyBackgroundPositionX)
             positionXProp = &prop;
         else if (prop.id() == CSSPropertyBackgroundPositionY)
@@ -877,25 +949,25 @@ String StylePropertySet::asText() const
 
 void StylePropertySet::merge(const StylePropertySet* other, bool argOverridesOnConflict)
 {
-    unsigned size = other->m_properties.size();
+    unsigned size = other->propertyCount();
     for (unsigned n = 0; n < size; ++n) {
-        const CSSProperty& toMerge = other->m_properties[n];
+        const CSSProperty& toMerge = other->propertyAt(n);
         CSSProperty* old = findPropertyWithId(toMerge.id());
         if (old) {
             if (!argOverridesOnConflict && old->value())
                 continue;
             setProperty(toMerge, old);
         } else
-            m_properties.append(toMerge);
+            mutablePropertyVector().append(toMerge);
     }
 }
 
 void StylePropertySet::addSubresourceStyleURLs(ListHashSet<KURL>& urls)
 {
     CSSStyleSheet* sheet = contextStyleSheet();
-    size_t size = m_properties.size();
-    for (size_t i = 0; i < size; ++i)
-        m_properties[i].value()->addSubresourceStyleURLs(urls, sheet);
+    unsigned size = propertyCount();
+    for (unsigned i = 0; i < size; ++i)
+        propertyAt(i).value()->addSubresourceStyleURLs(urls, sheet);
 }
 
 // This is the list of properties we want to copy in the copyBlockProperties() function.
@@ -938,7 +1010,7 @@ void StylePropertySet::removeBlockProperties()
 
 bool StylePropertySet::removePropertiesInSet(const int* set, unsigned length)
 {
-    if (m_properties.isEmpty())
+    if (isEmpty())
         return false;
 
     // FIXME: This is always used with static sets and in that case constructing the hash repeatedly is pretty pointless.
@@ -947,11 +1019,11 @@ bool StylePropertySet::removePropertiesInSet(const int* set, unsigned length)
         toRemove.add(set[i]);
 
     Vector<CSSProperty, 4> newProperties;
-    newProperties.reserveInitialCapacity(m_properties.size());
+    unsigned size = propertyCount();
+    newProperties.reserveInitialCapacity(size);
 
-    unsigned size = m_properties.size();
     for (unsigned n = 0; n < size; ++n) {
-        const CSSProperty& property = m_properties[n];
+        const CSSProperty& property = propertyAt(n);
         // Not quite sure if the isImportant test is needed but it matches the existing behavior.
         if (!property.isImportant()) {
             if (toRemove.contains(property.id()))
@@ -960,25 +1032,26 @@ bool StylePropertySet::removePropertiesInSet(const int* set, unsigned length)
         newProperties.append(property);
     }
 
-    bool changed = newProperties.size() != m_properties.size();
-    m_properties = newProperties;
+    bool changed = newProperties.size() != size;
+    mutablePropertyVector() = newProperties;
     return changed;
 }
 
 const CSSProperty* StylePropertySet::findPropertyWithId(int propertyID) const
 {
-    for (int n = m_properties.size() - 1 ; n >= 0; --n) {
-        if (propertyID == m_properties[n].m_id)
-            return &m_properties[n];
+    for (int n = propertyCount() - 1 ; n >= 0; --n) {
+        if (propertyID == propertyAt(n).m_id)
+            return &propertyAt(n);
     }
     return 0;
 }
 
 CSSProperty* StylePropertySet::findPropertyWithId(int propertyID)
 {
-    for (int n = m_properties.size() - 1 ; n >= 0; --n) {
-        if (propertyID == m_properties[n].m_id)
-            return &m_properties[n];
+    Vector<CSSProperty, 4>& properties = mutablePropertyVector();
+    for (int n = properties.size() - 1 ; n >= 0; --n) {
+        if (propertyID == properties[n].m_id)
+            return &properties[n];
     }
     return 0;
 }
@@ -992,9 +1065,9 @@ bool StylePropertySet::propertyMatches(const CSSProperty* property) const
 void StylePropertySet::removeEquivalentProperties(const StylePropertySet* style)
 {
     Vector<int> propertiesToRemove;
-    size_t size = m_properties.size();
-    for (size_t i = 0; i < size; ++i) {
-        const CSSProperty& property = m_properties[i];
+    unsigned size = propertyCount();
+    for (unsigned i = 0; i < size; ++i) {
+        const CSSProperty& property = propertyAt(i);
         if (style->propertyMatches(&property))
             propertiesToRemove.append(property.id());
     }    
@@ -1006,9 +1079,9 @@ void StylePropertySet::removeEquivalentProperties(const StylePropertySet* style)
 void StylePropertySet::removeEquivalentProperties(const CSSStyleDeclaration* style)
 {
     Vector<int> propertiesToRemove;
-    size_t size = m_properties.size();
-    for (size_t i = 0; i < size; ++i) {
-        const CSSProperty& property = m_properties[i];
+    unsigned size = propertyCount();
+    for (unsigned i = 0; i < size; ++i) {
+        const CSSProperty& property = propertyAt(i);
         if (style->cssPropertyMatches(&property))
             propertiesToRemove.append(property.id());
     }    
@@ -1019,7 +1092,23 @@ void StylePropertySet::removeEquivalentProperties(const CSSStyleDeclaration* sty
 
 PassRefPtr<StylePropertySet> StylePropertySet::copy() const
 {
-    return adoptRef(new StylePropertySet(m_properties));
+    if (m_isMutable)
+        return adoptRef(new StylePropertySet(*m_mutablePropertyVector));
+
+    Vector<CSSProperty> properties;
+    properties.reserveInitialCapacity(m_arraySize);
+    for (unsigned i = 0; i < m_arraySize; ++i)
+        properties.uncheckedAppend(immutablePropertyArray()[i]);
+    return adoptRef(new StylePropertySet(properties));
+}
+
+PassRefPtr<StylePropertySet> StylePropertySet::immutableCopy() const
+{
+    unsigned size = propertyCount();
+    Vector<const CSSProperty*, 32> properties(size);
+    for (unsigned i = 0; i < size; ++i)
+        properties[i] = &propertyAt(i);
+    return createImmutable(m_contextStyleSheet, m_strictParsing, properties.data(), size);
 }
 
 PassRefPtr<StylePropertySet> StylePropertySet::copyPropertiesInSet(const int* set, unsigned length) const
@@ -1269,9 +1358,9 @@ void InlineCSSStyleDeclaration::setNeedsStyleRecalc()
 }
 
 class SameSizeAsStylePropertySet : public RefCounted<SameSizeAsStylePropertySet> {
-    Vector<CSSProperty, 4> properties;
     unsigned bitfield;
     void* parent;
+    void* properties;
 };
 COMPILE_ASSERT(sizeof(StylePropertySet) == sizeof(SameSizeAsStylePropertySet), style_property_set_should_stay_small);
 
@@ -27,6 +27,7 @@
 #include "KURLHash.h"
 #include "PlatformString.h"
 #include <wtf/ListHashSet.h>
+#include <wtf/OwnPtr.h>
 #include <wtf/Vector.h>
 
 namespace WebCore {
@@ -46,18 +47,19 @@ public:
     {
         return adoptRef(new StylePropertySet(contextStyleSheet));
     }
-    static PassRefPtr<StylePropertySet> create(CSSStyleSheet* contextStyleSheet, const CSSProperty* const* properties, int numProperties)
-    {
-        return adoptRef(new StylePropertySet(contextStyleSheet, properties, numProperties));
-    }
     static PassRefPtr<StylePropertySet> create(const Vector<CSSProperty>& properties)
     {
         return adoptRef(new StylePropertySet(properties));
     }
+    // Used by the parser for the declaration blocks of style sheet rules. The properties are stored
+    // in the same allocation as the set, and are moved to a vector the first time the set is changed.
+    static PassRefPtr<StylePropertySet> createImmutable(CSSStyleSheet* contextStyleSheet, const CSSProperty* const* properties, int numProperties);
+
+    unsigned propertyCount() const { return m_isMutable ? m_mutablePropertyVector->size() : m_arraySize; }
+    bool isEmpty() const { return !propertyCount(); }
+    const CSSProperty& propertyAt(unsigned index) const { return m_isMutable ? m_mutablePropertyVector->at(index) : immutablePropertyArray()[index]; }
 
-    unsigned propertyCount() const { return m_properties.size(); }
-    bool isEmpty() const { return m_properties.isEmpty(); }
-    const CSSProperty& propertyAt(unsigned index) const { return m_properties[index]; }
+    bool isMutable() const { return m_isMutable; }
 
     PassRefPtr<CSSValue> getPropertyCSSValue(int propertyID) const;
     String getPropertyValue(int propertyID) const;
@@ -93,6 +95,8 @@ public:
     void addSubresourceStyleURLs(ListHashSet<KURL>&);
 
     PassRefPtr<StylePropertySet> copy() const;
+    // Returns a set with the same properties, context style sheet and parsing mode in the immutable layout.
+    PassRefPtr<StylePropertySet> immutableCopy() const;
     // Used by StyledElement::copyNonAttributeProperties().
     void copyPropertiesFrom(const StylePropertySet&);
 
@@ -112,12 +116,20 @@ public:
     CSSStyleDeclaration* ensureCSSStyleDeclaration() const;
     CSSStyleDeclaration* ensureRuleCSSStyleDeclaration(const CSSRule* parentRule) const;
     CSSStyleDeclaration* ensureInlineCSSStyleDeclaration(const StyledElement* parentElement) const;
+    bool hasCSSOMWrapper() const { return m_hasCSSOMWrapper; }
 
 private:
     StylePropertySet();
     StylePropertySet(const Vector<CSSProperty>&);
     StylePropertySet(CSSStyleSheet* parentStyleSheet);
     StylePropertySet(CSSStyleSheet* parentStyleSheet, const CSSProperty* const *, int numProperties);
+    StylePropertySet(CSSStyleSheet* parentStyleSheet, bool strictParsing, const CSSProperty* const*, unsigned numProperties);
+
+    static PassRefPtr<StylePropertySet> createImmutable(CSSStyleSheet* contextStyleSheet, bool strictParsing, const CSSProperty* const*, unsigned numProperties);
+
+    const CSSProperty* immutablePropertyArray() const { return reinterpret_cast<const CSSProperty*>(this + 1); }
+    CSSProperty* immutablePropertyArray() { return reinterpret_cast<CSSProperty*>(this + 1); }
+    Vector<CSSProperty, 4>& mutablePropertyVector();
 
     void setNeedsStyleRecalc();
 
@@ -139,12 +151,14 @@ private:
     const CSSProperty* findPropertyWithId(int propertyId) const;
     CSSProperty* findPropertyWithId(int propertyId);
 
-    Vector<CSSProperty, 4> m_properties;
-
-    bool m_strictParsing : 1;
-    mutable bool m_hasCSSOMWrapper : 1;
+    unsigned m_strictParsing : 1;
+    mutable unsigned m_hasCSSOMWrapper : 1;
+    unsigned m_isMutable : 1;
+    // Number of properties in the array that follows an immutable set.
+    unsigned m_arraySize : 29;
 
     CSSStyleSheet* m_contextStyleSheet;
+    OwnPtr<Vector<CSSProperty, 4> > m_mutablePropertyVector;
     
     friend class PropertySetCSSStyleDeclaration;
 };
@@ -141,6 +141,7 @@
 #include "ShadowRoot.h"
 #include "ShadowRootList.h"
 #include "StaticHashSetNodeList.h"
+#include "StylePropertySet.h"
 #include "StyleSheetList.h"
 #include "TextResourceDecoder.h"
 #include "Timer.h"
@@ -2538,6 +2539,10 @@ void Document::updateBaseURL()
         m_mappedElementSheet->setFinalURL(m_baseURL);
     
     if (!equalIgnoringFragmentIdentifier(oldBaseURL, m_baseURL)) {
+        // Shared inline styles have their URLs completed against the old base URL.
+        m_sharedInlineStyles[0].clear();
+        m_sharedInlineStyles[1].clear();
+
         // Base URL change changes any relative visited links.
         // FIXME: There are other URLs in the tree that would need to be re-evaluated on dynamic base URL change. Style should be invalidated too.
         for (Node* node = firstChild(); node; node = node->traverseNextNode()) {
@@ -2766,6 +2771,37 @@ CSSStyleSheet* Document::mappedElementSheet()
     return m_mappedElementSheet.get();
 }
 
+static const unsigned maxSharedInlineStyles = 1024;
+
+StylePropertySet* Document::sharedInlineStyle(const AtomicString& styleText, bool strictParsing)
+{
+    SharedInlineStyleMap& sharedStyles = m_sharedInlineStyles[strictParsing];
+    SharedInlineStyleMap::iterator it = sharedStyles.find(styleText);
+    if (it != sharedStyles.end())
+        return it->second.get();
+
+    if (sharedStyles.size() >= maxSharedInlineStyles) {
+        // Forget the styles no element uses any more.
+        Vector<AtomicString> unusedStyles;
+        SharedInlineStyleMap::iterator end = sharedStyles.end();
+        for (it = sharedStyles.begin(); it != end; ++it) {
+            if (it->second->hasOneRef())
+                unusedStyles.append(it->first);
+        }
+        for (size_t i = 0; i < unusedStyles.size(); ++i)
+            sharedStyles.remove(unusedStyles[i]);
+        if (sharedStyles.size() >= maxSharedInlineStyles)
+            return 0;
+    }
+
+    RefPtr<StylePropertySet> style = StylePropertySet::create(elementSheet());
+    style->setStrictParsing(strictParsing);
+    style->parseDeclaration(styleText);
+    RefPtr<StylePropertySet> sharedStyle = style->immutableCopy();
+    sharedStyles.set(styleText, sharedStyle);
+    return sharedStyle.get();
+}
+
 int Document::nodeAbsIndex(Node *node)
 {
     ASSERT(node->document() == this);
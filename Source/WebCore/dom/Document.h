@@ -54,6 +54,7 @@
 #include <wtf/OwnPtr.h>
 #include <wtf/PassOwnPtr.h>
 #include <wtf/PassRefPtr.h>
+#include <wtf/text/AtomicStringHash.h>
 
 namespace WebCore {
 
@@ -127,6 +128,7 @@ class SecurityOrigin;
 class SerializedScriptValue;
 class SegmentedString;
 class Settings;
+class StylePropertySet;
 class StyleSheet;
 class StyleSheetList;
 class Text;
@@ -633,6 +635,10 @@ public:
 
     CSSStyleSheet* elementSheet();
     CSSStyleSheet* mappedElementSheet();
+
+    // Style attributes with the same text share one immutable StylePropertySet, parsed against
+    // the element sheet. Returns 0 if the style should be parsed for the element alone.
+    StylePropertySet* sharedInlineStyle(const AtomicString& styleText, bool strictParsing);
     
     virtual PassRefPtr<DocumentParser> createParser();
     DocumentParser* parser() const { return m_parser.get(); }
@@ -1251,6 +1257,8 @@ private:
 
     RefPtr<CSSStyleSheet> m_elemSheet;
     RefPtr<CSSStyleSheet> m_mappedElementSheet;
+    typedef HashMap<AtomicString, RefPtr<StylePropertySet> > SharedInlineStyleMap;
+    SharedInlineStyleMap m_sharedInlineStyles[2]; // Indexed by whether the styles use strict parsing.
     RefPtr<CSSStyleSheet> m_pageUserSheet;
     mutable OwnPtr<Vector<RefPtr<CSSStyleSheet> > > m_pageGroupUserSheets;
     OwnPtr<Vector<RefPtr<CSSStyleSheet> > > m_userSheets;
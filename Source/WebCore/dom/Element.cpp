@@ -62,6 +62,7 @@
 #include "RenderWidget.h"
 #include "Settings.h"
 #include "ShadowRoot.h"
+#include "StyleInvalidationSet.h"
 #include "Text.h"
 #include "TextIterator.h"
 #include "WebKitMutationObserver.h"
@@ -659,10 +660,12 @@ void Element::attributeChanged(Attribute* attr)
     else if (attr->name() == HTMLNames::nameAttr)
         setHasName(!attr->isNull());
 
-    if (!needsStyleRecalc() && document()->attached()) {
+    if (styleChangeType() < FullStyleChange && document()->attached()) {
         CSSStyleSelector* styleSelector = document()->styleSelectorIfExists();
-        if (!styleSelector || styleSelector->hasSelectorForAttribute(attr->name().localName()))
+        if (!styleSelector)
             setNeedsStyleRecalc();
+        else if (const StyleInvalidationSet* invalidationSet = styleSelector->attributeInvalidationSet(attr->name().localName()))
+            invalidationSet->invalidate(this);
     }
 
     invalidateNodeListsCacheAfterAttributeChanged(attr->name());
@@ -697,6 +700,7 @@ void Element::attributeChanged(Attribute* attr)
 
 void Element::idAttributeChanged(Attribute* attr)
 {
+    AtomicString oldId = hasID() && attributeData() ? attributeData()->idForStyleResolution() : nullAtom;
     setHasID(!attr->isNull());
     if (attributeData()) {
         if (attr->isNull())
@@ -706,7 +710,23 @@ void Element::idAttributeChanged(Attribute* attr)
         else
             attributeData()->setIdForStyleResolution(attr->value());
     }
-    setNeedsStyleRecalc();
+    AtomicString newId = hasID() && attributeData() ? attributeData()->idForStyleResolution() : nullAtom;
+    if (oldId == newId)
+        return;
+
+    CSSStyleSelector* styleSelector = document()->styleSelectorIfExists();
+    if (!styleSelector) {
+        setNeedsStyleRecalc();
+        return;
+    }
+    if (!oldId.isNull()) {
+        if (const StyleInvalidationSet* invalidationSet = styleSelector->idInvalidationSet(oldId))
+            invalidationSet->invalidate(this);
+    }
+    if (!newId.isNull() && styleChangeType() < FullStyleChange) {
+        if (const StyleInvalidationSet* invalidationSet = styleSelector->idInvalidationSet(newId))
+            invalidationSet->invalidate(this);
+    }
 }
     
 // Returns true is the given attribute is an event handler.
@@ -1029,6 +1049,10 @@ void Element::recalcStyle(StyleChange change)
             return;
     }
 
+    OwnPtr<StyleInvalidationSet> pendingStyleInvalidationSet;
+    if (hasRareData())
+        pendingStyleInvalidationSet = rareData()->m_pendingStyleInvalidationSet.release();
+
     // Ref currentStyle in case it would otherwise be deleted when setRenderStyle() is called.
     RefPtr<RenderStyle> currentStyle(renderStyle());
     bool hasParentStyle = parentNodeForRenderingAndStyle() ? static_cast<bool>(parentNodeForRenderingAndStyle()->renderStyle()) : false;
@@ -1101,6 +1125,10 @@ void Element::recalcStyle(StyleChange change)
                 change = ch;
         }
     }
+    // Forcing restyles every descendant anyway.
+    if (pendingStyleInvalidationSet && change < Force)
+        pendingStyleInvalidationSet->invalidateDescendants(this);
+
     StyleSelectorParentPusher parentPusher(this);
     // FIXME: This check is good enough for :hover + foo, but it is not good enough for :hover + foo + bar.
     // For now we will just worry about the common case, since it's a lot trickier to get the second case right
@@ -1141,6 +1169,20 @@ void Element::recalcStyle(StyleChange change)
         didRecalcStyle(change);
 }
 
+void Element::addPendingStyleInvalidation(const StyleInvalidationSet& invalidationSet)
+{
+    ElementRareData* data = ensureRareData();
+    if (!data->m_pendingStyleInvalidationSet)
+        data->m_pendingStyleInvalidationSet = StyleInvalidationSet::create();
+    data->m_pendingStyleInvalidationSet->add(invalidationSet);
+
+    // Make sure the next style recalc reaches this element, without restyling it.
+    if (!childNeedsStyleRecalc()) {
+        setChildNeedsStyleRecalc();
+        markAncestorsWithChildNeedsStyleRecalc();
+    }
+}
+
 bool Element::hasShadowRoot() const
 {
     if (ShadowRootList* list = shadowRootList())
@@ -43,6 +43,7 @@ class ElementRareData;
 class IntSize;
 class ShadowRoot;
 class ShadowRootList;
+class StyleInvalidationSet;
 class WebKitAnimationList;
 
 enum SpellcheckAttributeState {
@@ -204,6 +205,9 @@ public:
     virtual CSSStyleDeclaration* style();
 
     const QualifiedName& tagQName() const { return m_tagName; }
+#if ENABLE(CSS_SELECTOR_JIT)
+    static ptrdiff_t tagQNameMemoryOffset() { return OBJECT_OFFSETOF(Element, m_tagName); }
+#endif
     String tagName() const { return nodeName(); }
     bool hasTagName(const QualifiedName& tagName) const { return m_tagName.matches(tagName); }
     
@@ -253,6 +257,10 @@ public:
     virtual RenderObject* createRenderer(RenderArena*, RenderStyle*);
     void recalcStyle(StyleChange = NoChange);
 
+    // Remembers which descendants a class, id or attribute change may restyle,
+    // so that they are looked for once, by the next style recalc.
+    void addPendingStyleInvalidation(const StyleInvalidationSet&);
+
     bool hasShadowRoot() const;
     ShadowRootList* shadowRootList() const;
 
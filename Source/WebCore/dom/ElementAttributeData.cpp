@@ -47,6 +47,12 @@ StylePropertySet* ElementAttributeData::ensureInlineStyleDecl(StyledElement* ele
         ASSERT(element->isStyledElement());
         m_inlineStyleDecl = StylePropertySet::create(element->document()->elementSheet());
         m_inlineStyleDecl->setStrictParsing(element->isHTMLElement() && !element->document()->inQuirksMode());
+    } else if (!m_inlineStyleDecl->isMutable()) {
+        // The style is shared with other elements, so changes go to a copy of our own.
+        RefPtr<StylePropertySet> inlineStyle = m_inlineStyleDecl->copy();
+        inlineStyle->setContextStyleSheet(m_inlineStyleDecl->contextStyleSheet());
+        inlineStyle->setStrictParsing(m_inlineStyleDecl->useStrictParsing());
+        m_inlineStyleDecl = inlineStyle.release();
     }
     return m_inlineStyleDecl.get();
 }
@@ -55,10 +61,18 @@ void ElementAttributeData::destroyInlineStyleDecl(StyledElement* element)
 {
     if (!m_inlineStyleDecl)
         return;
-    m_inlineStyleDecl->clearParentElement(element);
+    if (m_inlineStyleDecl->isMutable())
+        m_inlineStyleDecl->clearParentElement(element);
     m_inlineStyleDecl = 0;
 }
 
+void ElementAttributeData::setSharedInlineStyleDecl(StyledElement* element, PassRefPtr<StylePropertySet> inlineStyle)
+{
+    ASSERT(!inlineStyle->isMutable());
+    destroyInlineStyleDecl(element);
+    m_inlineStyleDecl = inlineStyle;
+}
+
 void ElementAttributeData::addAttribute(PassRefPtr<Attribute> prpAttribute, Element* element)
 {
     RefPtr<Attribute> attribute = prpAttribute;
@@ -49,6 +49,8 @@ public:
     StylePropertySet* inlineStyleDecl() { return m_inlineStyleDecl.get(); }
     StylePropertySet* ensureInlineStyleDecl(StyledElement*);
     void destroyInlineStyleDecl(StyledElement* element);
+    // Immutable inline styles are shared by the elements of a document that have the same style attribute.
+    void setSharedInlineStyleDecl(StyledElement*, PassRefPtr<StylePropertySet>);
 
     StylePropertySet* attributeStyle() const { return m_attributeStyle.get(); }
     void setAttributeStyle(PassRefPtr<StylePropertySet> style) { m_attributeStyle = style; }
@@ -28,6 +28,7 @@
 #include "HTMLCollection.h"
 #include "NodeRareData.h"
 #include "ShadowRootList.h"
+#include "StyleInvalidationSet.h"
 #include <wtf/OwnPtr.h>
 
 namespace WebCore {
@@ -69,6 +70,7 @@ public:
 
     OwnPtr<DatasetDOMStringMap> m_datasetDOMStringMap;
     OwnPtr<ClassList> m_classList;
+    OwnPtr<StyleInvalidationSet> m_pendingStyleInvalidationSet;
 
     bool m_styleAffectedByEmpty;
 
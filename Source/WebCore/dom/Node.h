@@ -645,6 +645,16 @@ public:
     bool hasScopedHTMLStyleChild() const;
     size_t numberOfScopedHTMLStyleChildren() const;
 
+#if ENABLE(CSS_SELECTOR_JIT)
+    // Used by SelectorCompiler to read nodes from generated code.
+    static ptrdiff_t parentMemoryOffset();
+    static ptrdiff_t nodeFlagsMemoryOffset() { return OBJECT_OFFSETOF(Node, m_nodeFlags); }
+    static uint32_t flagIsElement() { return IsElementFlag; }
+    static uint32_t flagHasID() { return HasIDFlag; }
+    static uint32_t flagHasClass() { return HasClassFlag; }
+    static uint32_t flagIsShadowRootOrSVGShadowRoot() { return IsShadowRootOrSVGShadowRootFlag; }
+#endif
+
 private:
     enum NodeFlags {
         IsTextFlag = 1,
@@ -729,6 +739,9 @@ protected:
     NodeRareData* ensureRareData();
     void clearRareData();
 
+    // Used to share code between lazyAttach and setNeedsStyleRecalc.
+    void markAncestorsWithChildNeedsStyleRecalc();
+
     bool hasCustomWillOrDidRecalcStyle() const { return getFlag(HasCustomWillOrDidRecalcStyleFlag); }
     void setHasCustomWillOrDidRecalcStyle() { setFlag(true, HasCustomWillOrDidRecalcStyleFlag); }
     
@@ -748,9 +761,6 @@ private:
 
     void setStyleChange(StyleChangeType);
 
-    // Used to share code between lazyAttach and setNeedsStyleRecalc.
-    void markAncestorsWithChildNeedsStyleRecalc();
-
     virtual void refEventTarget();
     virtual void derefEventTarget();
 
@@ -840,6 +850,16 @@ inline ContainerNode* Node::parentNodeGuaranteedHostFree() const
     return parentOrHostNode();
 }
 
+#if ENABLE(CSS_SELECTOR_JIT)
+inline ptrdiff_t Node::parentMemoryOffset()
+{
+    // The parent pointer lives in the TreeShared base, which does not start at the same address as the Node.
+    static const ptrdiff_t fakeNodeAddress = 0x4000;
+    TreeShared<ContainerNode>* treeShared = reinterpret_cast<Node*>(fakeNodeAddress);
+    return reinterpret_cast<ptrdiff_t>(treeShared) - fakeNodeAddress + TreeShared<ContainerNode>::parentMemoryOffset();
+}
+#endif
+
 inline void Node::reattach()
 {
     if (attached())
@@ -48,6 +48,11 @@ public:
         const AtomicString m_namespace;
         mutable AtomicString m_localNameUpper;
 
+#if ENABLE(CSS_SELECTOR_JIT)
+        static ptrdiff_t localNameMemoryOffset() { return OBJECT_OFFSETOF(QualifiedNameImpl, m_localName); }
+        static ptrdiff_t namespaceMemoryOffset() { return OBJECT_OFFSETOF(QualifiedNameImpl, m_namespace); }
+#endif
+
     private:
         QualifiedNameImpl(const AtomicString& prefix, const AtomicString& localName, const AtomicString& namespaceURI)
             : m_prefix(prefix)
@@ -88,6 +93,9 @@ public:
     String toString() const;
 
     QualifiedNameImpl* impl() const { return m_impl; }
+#if ENABLE(CSS_SELECTOR_JIT)
+    static ptrdiff_t implMemoryOffset() { return OBJECT_OFFSETOF(QualifiedName, m_impl); }
+#endif
     
     // Init routine for globals
     static void init();
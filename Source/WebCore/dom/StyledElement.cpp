@@ -37,6 +37,7 @@
 #include "Document.h"
 #include "HTMLNames.h"
 #include "HTMLParserIdioms.h"
+#include "StyleInvalidationSet.h"
 #include "StylePropertySet.h"
 #include <wtf/HashFunctions.h>
 
@@ -65,7 +66,9 @@ void StyledElement::insertedIntoDocument()
 {
     Element::insertedIntoDocument();
 
-    if (StylePropertySet* inlineStyle = inlineStyleDecl())
+    // A shared inline style keeps the element sheet of the document it was parsed for.
+    StylePropertySet* inlineStyle = inlineStyleDecl();
+    if (inlineStyle && inlineStyle->isMutable())
         inlineStyle->setContextStyleSheet(document()->elementSheet());
     if (StylePropertySet* attributeStyle = attributeData() ? attributeData()->attributeStyle() : 0)
         attributeStyle->setContextStyleSheet(document()->elementSheet());
@@ -75,12 +78,23 @@ void StyledElement::removedFromDocument()
 {
     Element::removedFromDocument();
 
-    if (StylePropertySet* inlineStyle = inlineStyleDecl())
+    StylePropertySet* inlineStyle = inlineStyleDecl();
+    if (inlineStyle && inlineStyle->isMutable())
         inlineStyle->setContextStyleSheet(0);
     if (StylePropertySet* attributeStyle = attributeData() ? attributeData()->attributeStyle() : 0)
         attributeStyle->setContextStyleSheet(0);
 }
 
+void StyledElement::didMoveToNewDocument(Document* oldDocument)
+{
+    // A shared inline style belongs to the old document, so take a copy of it.
+    StylePropertySet* inlineStyle = inlineStyleDecl();
+    if (inlineStyle && !inlineStyle->isMutable())
+        ensureInlineStyleDecl()->setContextStyleSheet(document()->elementSheet());
+
+    Element::didMoveToNewDocument(oldDocument);
+}
+
 void StyledElement::attributeChanged(Attribute* attr)
 {
     if (!(attr->name() == styleAttr && isSynchronizingStyleAttribute()))
@@ -96,6 +110,10 @@ void StyledElement::attributeChanged(Attribute* attr)
 
 void StyledElement::classAttributeChanged(const AtomicString& newClassString)
 {
+    SpaceSplitString oldClasses;
+    if (hasClass())
+        oldClasses = classNames();
+
     const UChar* characters = newClassString.characters();
     unsigned length = newClassString.length();
     unsigned i;
@@ -112,7 +130,32 @@ void StyledElement::classAttributeChanged(const AtomicString& newClassString)
             static_cast<ClassList*>(classList)->reset(newClassString);
     } else if (attributeData())
         attributeData()->clearClass();
-    setNeedsStyleRecalc();
+    invalidateStyleForClassChange(oldClasses, hasClass ? classNames() : SpaceSplitString());
+}
+
+void StyledElement::invalidateStyleForClassChange(const SpaceSplitString& oldClasses, const SpaceSplitString& newClasses)
+{
+    CSSStyleSelector* styleSelector = document()->styleSelectorIfExists();
+    if (!styleSelector) {
+        setNeedsStyleRecalc();
+        return;
+    }
+
+    // Only the classes that were added or removed can change which selectors match.
+    size_t oldCount = oldClasses.size();
+    for (size_t i = 0; i < oldCount && styleChangeType() < FullStyleChange; ++i) {
+        if (newClasses.contains(oldClasses[i]))
+            continue;
+        if (const StyleInvalidationSet* invalidationSet = styleSelector->classInvalidationSet(oldClasses[i]))
+            invalidationSet->invalidate(this);
+    }
+    size_t newCount = newClasses.size();
+    for (size_t i = 0; i < newCount && styleChangeType() < FullStyleChange; ++i) {
+        if (oldClasses.contains(newClasses[i]))
+            continue;
+        if (const StyleInvalidationSet* invalidationSet = styleSelector->classInvalidationSet(newClasses[i]))
+            invalidationSet->invalidate(this);
+    }
 }
 
 void StyledElement::parseAttribute(Attribute* attr)
@@ -123,13 +166,27 @@ void StyledElement::parseAttribute(Attribute* attr)
         if (attr->isNull())
             destroyInlineStyleDecl();
         else if (document()->contentSecurityPolicy()->allowInlineStyle())
-            ensureInlineStyleDecl()->parseDeclaration(attr->value());
+            setInlineStyleFromAttribute(attr->value());
         setIsStyleAttributeValid();
         setNeedsStyleRecalc();
         InspectorInstrumentation::didInvalidateStyleAttr(document(), this);
     }
 }
 
+void StyledElement::setInlineStyleFromAttribute(const AtomicString& styleText)
+{
+    // A style that script holds a CSSStyleDeclaration for is reparsed in place, so the declaration stays live.
+    StylePropertySet* inlineStyle = inlineStyleDecl();
+    if (!inlineStyle || !inlineStyle->hasCSSOMWrapper()) {
+        bool strictParsing = isHTMLElement() && !document()->inQuirksMode();
+        if (StylePropertySet* sharedStyle = document()->sharedInlineStyle(styleText, strictParsing)) {
+            ensureAttributeData()->setSharedInlineStyleDecl(this, sharedStyle);
+            return;
+        }
+    }
+    ensureInlineStyleDecl()->parseDeclaration(styleText);
+}
+
 void StyledElement::inlineStyleChanged()
 {
     setNeedsStyleRecalc(InlineStyleChange);
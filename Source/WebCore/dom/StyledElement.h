@@ -76,10 +76,13 @@ protected:
     
     virtual void insertedIntoDocument();
     virtual void removedFromDocument();
+    virtual void didMoveToNewDocument(Document* oldDocument) OVERRIDE;
 
 private:
     virtual void updateStyleAttribute() const;
     void inlineStyleChanged();
+    void setInlineStyleFromAttribute(const AtomicString& styleText);
+    void invalidateStyleForClassChange(const SpaceSplitString& oldClasses, const SpaceSplitString& newClasses);
 
     void updateAttributeStyle();
 
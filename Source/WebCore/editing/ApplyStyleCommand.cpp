@@ -889,14 +889,14 @@ bool ApplyStyleCommand::removeCSSStyle(EditingStyle* style, HTMLElement* element
     if (!style->conflictsWithInlineStyleOfElement(element, extractedStyle, properties))
         return false;
 
-    StylePropertySet* inlineStyle = element->inlineStyleDecl();
-    ASSERT(inlineStyle);
+    ASSERT(element->inlineStyleDecl());
     // FIXME: We should use a mass-removal function here but we don't have an undoable one yet.
     for (size_t i = 0; i < properties.size(); i++)
         removeCSSProperty(element, properties[i]);
 
-    // No need to serialize <foo style=""> if we just removed the last css property
-    if (inlineStyle->isEmpty())
+    // No need to serialize <foo style=""> if we just removed the last css property.
+    // The element may no longer share its old inline style, so look it up again.
+    if (element->inlineStyleDecl()->isEmpty())
         removeNodeAttribute(element, styleAttr);
 
     if (isSpanWithoutAttributesOrUnstyledStyleSpan(element))
@@ -1184,12 +1184,17 @@ void StyledElement::copyNonAttributeProperties(const Element* sourceElement)
     ASSERT(sourceElement->isStyledElement());
 
     const StyledElement* source = static_cast<const StyledElement*>(sourceElement);
-    if (!source->inlineStyleDecl())
+    StylePropertySet* sourceStyle = source->inlineStyleDecl();
+    if (!sourceStyle)
         return;
 
-    StylePropertySet* inlineStyle = ensureInlineStyleDecl();
-    inlineStyle->copyPropertiesFrom(*source->inlineStyleDecl());
-    inlineStyle->setStrictParsing(source->inlineStyleDecl()->useStrictParsing());
+    if (!sourceStyle->isMutable() && source->document() == document())
+        ensureAttributeData()->setSharedInlineStyleDecl(this, sourceStyle);
+    else {
+        StylePropertySet* inlineStyle = ensureInlineStyleDecl();
+        inlineStyle->copyPropertiesFrom(*sourceStyle);
+        inlineStyle->setStrictParsing(sourceStyle->useStrictParsing());
+    }
 
     setIsStyleAttributeValid(source->isStyleAttributeValid());
     setIsSynchronizingStyleAttribute(source->isSynchronizingStyleAttribute());
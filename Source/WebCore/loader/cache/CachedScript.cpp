@@ -35,6 +35,7 @@
 #include <wtf/Vector.h>
 
 #if USE(JSC)  
+#include "SourceProviderCacheStorage.h"
 #include <parser/SourceProvider.h>
 #endif
 
@@ -44,6 +45,9 @@ CachedScript::CachedScript(const ResourceRequest& resourceRequest, const String&
     : CachedResource(resourceRequest, Script)
     , m_decoder(TextResourceDecoder::create("application/javascript", charset))
     , m_decodedDataDeletionTimer(this, &CachedScript::decodedDataDeletionTimerFired)
+#if USE(JSC)
+    , m_sourceProviderCacheChanged(false)
+#endif
 {
     // It's javascript we want.
     // But some websites think their scripts are <some wrong mimetype here>
@@ -53,6 +57,9 @@ CachedScript::CachedScript(const ResourceRequest& resourceRequest, const String&
 
 CachedScript::~CachedScript()
 {
+#if USE(JSC)
+    storeSourceProviderCache();
+#endif
 }
 
 void CachedScript::didAddClient(CachedResourceClient* c)
@@ -114,11 +121,16 @@ void CachedScript::error(CachedResource::Status status)
 
 void CachedScript::destroyDecodedData()
 {
+#if USE(JSC)
+    storeSourceProviderCache();
+#endif
     m_script = String();
     unsigned extraSize = 0;
 #if USE(JSC)
-    if (m_sourceProviderCache && m_clients.isEmpty())
-        m_sourceProviderCache->clear();
+    // Nothing parses this source right now. The cache itself lives on in
+    // SourceProviderCacheStorage, so a later load of the same text still gets it.
+    if (m_clients.isEmpty())
+        m_sourceProviderCache = 0;
 
     extraSize = m_sourceProviderCache ? m_sourceProviderCache->byteSize() : 0;
 #endif
@@ -133,17 +145,32 @@ void CachedScript::decodedDataDeletionTimerFired(Timer<CachedScript>*)
 }
 
 #if USE(JSC)
-JSC::SourceProviderCache* CachedScript::sourceProviderCache() const
+JSC::SourceProviderCache* CachedScript::sourceProviderCache()
 {   
-    if (!m_sourceProviderCache) 
-        m_sourceProviderCache = adoptPtr(new JSC::SourceProviderCache); 
+    if (!m_sourceProviderCache) {
+        m_sourceProviderCache = SourceProviderCacheStorage::shared().cacheForSource(script(), TextPosition::minimumPosition(), &m_sourceProviderCacheKey);
+        if (m_sourceProviderCache)
+            setDecodedSize(decodedSize() + m_sourceProviderCache->byteSize());
+        else
+            m_sourceProviderCache = JSC::SourceProviderCache::create();
+    }
     return m_sourceProviderCache.get(); 
 }
 
 void CachedScript::sourceProviderCacheSizeChanged(int delta)
 {
+    m_sourceProviderCacheChanged = true;
     setDecodedSize(decodedSize() + delta);
 }
+
+void CachedScript::storeSourceProviderCache()
+{
+    if (!m_sourceProviderCache || !m_sourceProviderCacheChanged || m_sourceProviderCacheKey.isNull() || !SourceProviderCacheStorage::isWorthStoring(m_script))
+        return;
+
+    SourceProviderCacheStorage::shared().store(m_sourceProviderCacheKey, m_script, m_sourceProviderCache.get());
+    m_sourceProviderCacheChanged = false;
+}
 #endif
 
 } // namespace WebCore
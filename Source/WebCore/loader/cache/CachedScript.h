@@ -58,18 +58,23 @@ namespace WebCore {
         virtual void destroyDecodedData();
 #if USE(JSC)        
         // Allows JSC to cache additional information about the source.
-        JSC::SourceProviderCache* sourceProviderCache() const;
+        JSC::SourceProviderCache* sourceProviderCache();
         void sourceProviderCacheSizeChanged(int delta);
 #endif
     private:
         void decodedDataDeletionTimerFired(Timer<CachedScript>*);
+#if USE(JSC)
+        void storeSourceProviderCache();
+#endif
         virtual PurgePriority purgePriority() const { return PurgeLast; }
 
         String m_script;
         RefPtr<TextResourceDecoder> m_decoder;
         Timer<CachedScript> m_decodedDataDeletionTimer;
 #if USE(JSC)        
-        mutable OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
+        RefPtr<JSC::SourceProviderCache> m_sourceProviderCache;
+        String m_sourceProviderCacheKey;
+        bool m_sourceProviderCacheChanged;
 #endif
     };
 }
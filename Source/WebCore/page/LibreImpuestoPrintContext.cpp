@@ -37,10 +37,16 @@
 #include "RenderObject.h"
 #include "RenderTableCell.h"
 #include "RenderTableRow.h"
+#include "RenderTableSection.h"
 #include "NodeList.h"
 #include <wtf/text/WTFString.h>
 #include "PlatformContextCairo.h"
 
+#if USE(CAIRO)
+#include <cairo.h>
+#include <wtf/ParallelJobs.h>
+#endif
+
 namespace WebCore {
 
 // By imaging to a width a little wider than the available pixels,
@@ -58,6 +64,11 @@ const float printingMaximumShrinkFactor = 2;
 
 LibreImpuestoPrintContext::LibreImpuestoPrintContext(Frame* header, Frame* frame, Frame* footer)
     : m_contentFrame(frame), m_headerFrame(header), m_footerFrame(footer)
+    , m_firstPageNumber(0)
+    , m_isStreaming(false)
+#if USE(CAIRO)
+    , m_isSnapshottingPages(false)
+#endif
     , m_isPrinting(false)
 {
 }
@@ -68,59 +79,120 @@ LibreImpuestoPrintContext::~LibreImpuestoPrintContext()
         end();
 }
 
-// Called after begin
-void LibreImpuestoPrintContext::computePageRects(const FloatRect& printRect, float headerHeight, float footerHeight, float userScaleFactor, float& outPageHeight, bool allowHorizontalTiling)
+bool LibreImpuestoPrintContext::computePageSize(const FloatRect& printRect, float headerHeight, float footerHeight, float userScaleFactor, float& outPageHeight, FloatSize& outPageSize)
 {
-    RenderView* view;
-
-    m_pageContentRects.clear();
-    m_pageHeaderRects.clear();
     outPageHeight = 0;
 
     if (!m_contentFrame->document() || !m_contentFrame->view() || !m_contentFrame->document()->renderer())
-        return;
+        return false;
 
     if (userScaleFactor <= 0) {
         LOG_ERROR("userScaleFactor has bad value %.2f", userScaleFactor);
-        return;
+        return false;
     }
 
-    view = toRenderView(m_contentFrame->document()->renderer());
+    RenderView* view = toRenderView(m_contentFrame->document()->renderer());
     const IntRect& documentRect = view->documentRect();
     FloatSize pageSize = m_contentFrame->resizePageRectsKeepingRatio(FloatSize(printRect.width(), printRect.height()), FloatSize(documentRect.width(), documentRect.height()));
 
     pageSize.setHeight( pageSize.height() - headerHeight - footerHeight );
 
-    float pageWidth = pageSize.width();
-    float pageHeight = pageSize.height();
+    outPageHeight = pageSize.height(); // this is the height of the page adjusted by margins
+    outPageSize = FloatSize(pageSize.width() / userScaleFactor, pageSize.height() / userScaleFactor);
+    return true;
+}
 
-    outPageHeight = pageHeight; // this is the height of the page adjusted by margins
+// Called after begin
+void LibreImpuestoPrintContext::computePageRects(const FloatRect& printRect, float headerHeight, float footerHeight, float userScaleFactor, float& outPageHeight, bool allowHorizontalTiling)
+{
+    m_pageContentRects.clear();
+    m_pageHeaderRects.clear();
+    m_firstPageNumber = 0;
+    m_isStreaming = false;
 
-    computeHeaderPageRectsWithPageSizeInternal(FloatSize(pageWidth / userScaleFactor, pageHeight / userScaleFactor), allowHorizontalTiling);
+    FloatSize pageSize;
+    if (!computePageSize(printRect, headerHeight, footerHeight, userScaleFactor, outPageHeight, pageSize))
+        return;
 
-    if (pageHeight <= 0) {
-        LOG_ERROR("pageHeight has bad value %.2f", pageHeight);
+    computeHeaderPageRectsWithPageSizeInternal(pageSize, allowHorizontalTiling);
+
+    if (outPageHeight <= 0) {
+        LOG_ERROR("pageHeight has bad value %.2f", outPageHeight);
         return;
     }
 
-    computePageRectsWithPageSizeInternal(FloatSize(pageWidth / userScaleFactor, pageHeight / userScaleFactor), allowHorizontalTiling);
+    computePageRectsWithPageSizeInternal(pageSize, allowHorizontalTiling);
+}
+
+// Called after begin. Only the page geometry is computed here, the page rects are
+// produced on demand by computeNextPageRects().
+void LibreImpuestoPrintContext::beginStreaming(const FloatRect& printRect, float headerHeight, float footerHeight, float userScaleFactor, float& outPageHeight, bool allowHorizontalTiling)
+{
+    m_pageContentRects.clear();
+    m_pageHeaderRects.clear();
+    m_firstPageNumber = 0;
+    m_isStreaming = true;
+    m_contentGeometry = PageGeometry();
+
+    FloatSize pageSize;
+    if (!computePageSize(printRect, headerHeight, footerHeight, userScaleFactor, outPageHeight, pageSize))
+        return;
+
+    if (outPageHeight <= 0) {
+        LOG_ERROR("pageHeight has bad value %.2f", outPageHeight);
+        return;
+    }
+
+    computePageGeometry(m_contentFrame, pageSize, allowHorizontalTiling, m_contentGeometry);
+}
+
+bool LibreImpuestoPrintContext::computeNextPageRects(size_t maxPageCount)
+{
+    size_t totalPageCount = m_contentGeometry.pageCount();
+    size_t pageNumber = pageCount();
+
+    for (size_t i = 0; i < maxPageCount && pageNumber < totalPageCount; ++i, ++pageNumber)
+        m_pageContentRects.append(pageRectForGeometry(m_contentGeometry, pageNumber));
+
+    return pageNumber >= totalPageCount;
+}
 
+void LibreImpuestoPrintContext::discardPageRectsBefore(size_t pageNumber)
+{
+    if (pageNumber <= m_firstPageNumber)
+        return;
+
+    size_t count = std::min(pageNumber - m_firstPageNumber, m_pageContentRects.size());
+    m_pageContentRects.remove(0, count);
+    m_firstPageNumber += count;
+}
+
+IntRect LibreImpuestoPrintContext::pageRect(size_t pageNumber) const
+{
+    // Rects dropped by discardPageRectsBefore() are recomputed from the page geometry.
+    if (pageNumber < m_firstPageNumber)
+        return pageRectForGeometry(m_contentGeometry, pageNumber);
+    return m_pageContentRects[pageNumber - m_firstPageNumber];
 }
 
 void LibreImpuestoPrintContext::computePageRectsWithPageSize(const FloatSize& pageSizeInPixels, bool allowHorizontalTiling)
 {
     m_pageContentRects.clear();
     m_pageHeaderRects.clear();
+    m_firstPageNumber = 0;
+    m_isStreaming = false;
     computePageRectsWithPageSizeInternal(pageSizeInPixels, allowHorizontalTiling);
 }
 
 
-void LibreImpuestoPrintContext::computeHeaderPageRectsWithPageSizeInternal(const FloatSize& pageSizeInPixels, bool allowInlineDirectionTiling)
+bool LibreImpuestoPrintContext::computePageGeometry(Frame* frame, const FloatSize& pageSizeInPixels, bool allowInlineDirectionTiling, PageGeometry& geometry)
 {
-    if (!m_headerFrame->document() || !m_headerFrame->view() || !m_headerFrame->document()->renderer())
-        return;
+    geometry = PageGeometry();
 
-    RenderView* view = toRenderView(m_headerFrame->document()->renderer());
+    if (!frame || !frame->document() || !frame->view() || !frame->document()->renderer())
+        return false;
+
+    RenderView* view = toRenderView(frame->document()->renderer());
 
     IntRect docRect = view->documentRect();
 
@@ -130,155 +202,131 @@ void LibreImpuestoPrintContext::computeHeaderPageRectsWithPageSizeInternal(const
     bool isHorizontal = view->style()->isHorizontalWritingMode();
 
     int docLogicalHeight = isHorizontal ? docRect.height() : docRect.width();
-    int pageLogicalHeight = isHorizontal ? pageHeight : pageWidth;
-    int pageLogicalWidth = isHorizontal ? pageWidth : pageHeight;
+    geometry.pageLogicalHeight = isHorizontal ? pageHeight : pageWidth;
+    geometry.pageLogicalWidth = isHorizontal ? pageWidth : pageHeight;
+    geometry.isHorizontal = isHorizontal;
+    geometry.allowInlineDirectionTiling = allowInlineDirectionTiling;
 
-    int inlineDirectionStart;
-    int inlineDirectionEnd;
-    int blockDirectionStart;
-    int blockDirectionEnd;
     if (isHorizontal) {
         if (view->style()->isFlippedBlocksWritingMode()) {
-            blockDirectionStart = docRect.maxY();
-            blockDirectionEnd = docRect.y();
+            geometry.blockDirectionStart = docRect.maxY();
+            geometry.blockDirectionEnd = docRect.y();
         } else {
-            blockDirectionStart = docRect.y();
-            blockDirectionEnd = docRect.maxY();
+            geometry.blockDirectionStart = docRect.y();
+            geometry.blockDirectionEnd = docRect.maxY();
         }
-        inlineDirectionStart = view->style()->isLeftToRightDirection() ? docRect.x() : docRect.maxX();
-        inlineDirectionEnd = view->style()->isLeftToRightDirection() ? docRect.maxX() : docRect.x();
+        geometry.inlineDirectionStart = view->style()->isLeftToRightDirection() ? docRect.x() : docRect.maxX();
+        geometry.inlineDirectionEnd = view->style()->isLeftToRightDirection() ? docRect.maxX() : docRect.x();
     } else {
         if (view->style()->isFlippedBlocksWritingMode()) {
-            blockDirectionStart = docRect.maxX();
-            blockDirectionEnd = docRect.x();
+            geometry.blockDirectionStart = docRect.maxX();
+            geometry.blockDirectionEnd = docRect.x();
         } else {
-            blockDirectionStart = docRect.x();
-            blockDirectionEnd = docRect.maxX();
+            geometry.blockDirectionStart = docRect.x();
+            geometry.blockDirectionEnd = docRect.maxX();
         }
-        inlineDirectionStart = view->style()->isLeftToRightDirection() ? docRect.y() : docRect.maxY();
-        inlineDirectionEnd = view->style()->isLeftToRightDirection() ? docRect.maxY() : docRect.y();
+        geometry.inlineDirectionStart = view->style()->isLeftToRightDirection() ? docRect.y() : docRect.maxY();
+        geometry.inlineDirectionEnd = view->style()->isLeftToRightDirection() ? docRect.maxY() : docRect.y();
     }
 
-    unsigned pageCount = ceilf((float)docLogicalHeight / pageLogicalHeight);
-    for (unsigned i = 0; i < pageCount; ++i) {
-        int pageLogicalTop = blockDirectionEnd > blockDirectionStart ?
-                                blockDirectionStart + i * pageLogicalHeight : 
-                                blockDirectionStart - (i + 1) * pageLogicalHeight;
-        if (allowInlineDirectionTiling) {
-            for (int currentInlinePosition = inlineDirectionStart;
-                 inlineDirectionEnd > inlineDirectionStart ? currentInlinePosition < inlineDirectionEnd : currentInlinePosition > inlineDirectionEnd;
-                 currentInlinePosition += (inlineDirectionEnd > inlineDirectionStart ? pageLogicalWidth : -pageLogicalWidth)) {
-                int pageLogicalLeft = inlineDirectionEnd > inlineDirectionStart ? currentInlinePosition : currentInlinePosition - pageLogicalWidth;
-                IntRect pageRect(pageLogicalLeft, pageLogicalTop, pageLogicalWidth, pageLogicalHeight);
-                if (!isHorizontal)
-                    pageRect = pageRect.transposedRect();
-                m_pageHeaderRects.append(pageRect);
-            }
-        } else {
-            int pageLogicalLeft = inlineDirectionEnd > inlineDirectionStart ? inlineDirectionStart : inlineDirectionStart - pageLogicalWidth;
-            IntRect pageRect(pageLogicalLeft, pageLogicalTop, pageLogicalWidth, pageLogicalHeight);
-            if (!isHorizontal)
-                pageRect = pageRect.transposedRect();
-            m_pageHeaderRects.append(pageRect);
-        }
-    }
+    if (geometry.pageLogicalHeight <= 0 || geometry.pageLogicalWidth <= 0)
+        return false;
+
+    geometry.blockPageCount = ceilf((float)docLogicalHeight / geometry.pageLogicalHeight);
+    if (allowInlineDirectionTiling) {
+        int inlineLength = abs(geometry.inlineDirectionEnd - geometry.inlineDirectionStart);
+        geometry.inlinePageCount = ceilf((float)inlineLength / geometry.pageLogicalWidth);
+    } else
+        geometry.inlinePageCount = 1;
+
+    return true;
 }
 
+IntRect LibreImpuestoPrintContext::pageRectForGeometry(const PageGeometry& geometry, size_t index)
+{
+    ASSERT(index < geometry.pageCount());
+
+    bool blockForward = geometry.blockDirectionEnd > geometry.blockDirectionStart;
+    bool inlineForward = geometry.inlineDirectionEnd > geometry.inlineDirectionStart;
+    int blockIndex = index / geometry.inlinePageCount;
+    int inlineIndex = index % geometry.inlinePageCount;
+
+    int pageLogicalTop = blockForward ?
+                            geometry.blockDirectionStart + blockIndex * geometry.pageLogicalHeight :
+                            geometry.blockDirectionStart - (blockIndex + 1) * geometry.pageLogicalHeight;
+    int pageLogicalLeft;
+    if (geometry.allowInlineDirectionTiling) {
+        int currentInlinePosition = geometry.inlineDirectionStart + (inlineForward ? inlineIndex : -inlineIndex) * geometry.pageLogicalWidth;
+        pageLogicalLeft = inlineForward ? currentInlinePosition : currentInlinePosition - geometry.pageLogicalWidth;
+    } else
+        pageLogicalLeft = inlineForward ? geometry.inlineDirectionStart : geometry.inlineDirectionStart - geometry.pageLogicalWidth;
+
+    IntRect pageRect(pageLogicalLeft, pageLogicalTop, geometry.pageLogicalWidth, geometry.pageLogicalHeight);
+    if (!geometry.isHorizontal)
+        pageRect = pageRect.transposedRect();
+    return pageRect;
+}
 
-void LibreImpuestoPrintContext::computePageRectsWithPageSizeInternal(const FloatSize& pageSizeInPixels, bool allowInlineDirectionTiling)
+void LibreImpuestoPrintContext::computeHeaderPageRectsWithPageSizeInternal(const FloatSize& pageSizeInPixels, bool allowInlineDirectionTiling)
 {
-    if (!m_contentFrame->document() || !m_contentFrame->view() || !m_contentFrame->document()->renderer())
+    PageGeometry geometry;
+    if (!computePageGeometry(m_headerFrame, pageSizeInPixels, allowInlineDirectionTiling, geometry))
         return;
 
-    RenderView* view = toRenderView(m_contentFrame->document()->renderer());
+    size_t pageCount = geometry.pageCount();
+    for (size_t i = 0; i < pageCount; ++i)
+        m_pageHeaderRects.append(pageRectForGeometry(geometry, i));
+}
 
-    IntRect docRect = view->documentRect();
+void LibreImpuestoPrintContext::computePageRectsWithPageSizeInternal(const FloatSize& pageSizeInPixels, bool allowInlineDirectionTiling)
+{
+    if (!computePageGeometry(m_contentFrame, pageSizeInPixels, allowInlineDirectionTiling, m_contentGeometry))
+        return;
 
-    int pageWidth = pageSizeInPixels.width();
-    int pageHeight = pageSizeInPixels.height();
+    size_t pageCount = m_contentGeometry.pageCount();
+    for (size_t i = 0; i < pageCount; ++i)
+        m_pageContentRects.append(pageRectForGeometry(m_contentGeometry, i));
+}
 
-    bool isHorizontal = view->style()->isHorizontalWritingMode();
+// Simulates the row pagination done by RenderTableSection::layoutPaginatedRows() as if a
+// header row were inserted at the top of every page the section spans. All insertion points
+// are derived from the current layout, so the DOM only needs to be mutated and laid out once.
+// |documentShift| accumulates how much the inserted rows push down the content that follows.
+void LibreImpuestoPrintContext::collectHeaderInsertions(RenderTableSection* section, HTMLTableRowElement* head, int headLogicalHeight, int pageHeight, int& documentShift, Vector<HeaderInsertion>& insertions)
+{
+    const Vector<int>& rowPos = section->rowPositions();
+    unsigned totalRows = section->numRows();
+    if (!totalRows || rowPos.size() <= totalRows)
+        return;
 
-    int docLogicalHeight = isHorizontal ? docRect.height() : docRect.width();
-    int pageLogicalHeight = isHorizontal ? pageHeight : pageWidth;
-    int pageLogicalWidth = isHorizontal ? pageWidth : pageHeight;
+    int sectionTop = roundedLayoutPoint(section->localToAbsolute()).y() + documentShift;
+    int position = sectionTop + rowPos[0];
 
-    int inlineDirectionStart;
-    int inlineDirectionEnd;
-    int blockDirectionStart;
-    int blockDirectionEnd;
-    if (isHorizontal) {
-        if (view->style()->isFlippedBlocksWritingMode()) {
-            blockDirectionStart = docRect.maxY();
-            blockDirectionEnd = docRect.y();
-        } else {
-            blockDirectionStart = docRect.y();
-            blockDirectionEnd = docRect.maxY();
-        }
-        inlineDirectionStart = view->style()->isLeftToRightDirection() ? docRect.x() : docRect.maxX();
-        inlineDirectionEnd = view->style()->isLeftToRightDirection() ? docRect.maxX() : docRect.x();
-    } else {
-        if (view->style()->isFlippedBlocksWritingMode()) {
-            blockDirectionStart = docRect.maxX();
-            blockDirectionEnd = docRect.x();
-        } else {
-            blockDirectionStart = docRect.x();
-            blockDirectionEnd = docRect.maxX();
+    for (unsigned row = 0; row < totalRows; row++) {
+        int rowHeight = rowPos[row + 1] - rowPos[row];
+        int offsetInPage = position % pageHeight;
+
+        // A row that straddles a page boundary is moved to the top of the next page.
+        if (offsetInPage && offsetInPage + rowHeight > pageHeight) {
+            position += pageHeight - offsetInPage;
+            offsetInPage = 0;
         }
-        inlineDirectionStart = view->style()->isLeftToRightDirection() ? docRect.y() : docRect.maxY();
-        inlineDirectionEnd = view->style()->isLeftToRightDirection() ? docRect.maxY() : docRect.y();
-    }
 
-    unsigned pageCount = ceilf((float)docLogicalHeight / pageLogicalHeight);
-    for (unsigned i = 0; i < pageCount; ++i) {
-        int pageLogicalTop = blockDirectionEnd > blockDirectionStart ?
-                                blockDirectionStart + i * pageLogicalHeight : 
-                                blockDirectionStart - (i + 1) * pageLogicalHeight;
-        if (allowInlineDirectionTiling) {
-            for (int currentInlinePosition = inlineDirectionStart;
-                 inlineDirectionEnd > inlineDirectionStart ? currentInlinePosition < inlineDirectionEnd : currentInlinePosition > inlineDirectionEnd;
-                 currentInlinePosition += (inlineDirectionEnd > inlineDirectionStart ? pageLogicalWidth : -pageLogicalWidth)) {
-                int pageLogicalLeft = inlineDirectionEnd > inlineDirectionStart ? currentInlinePosition : currentInlinePosition - pageLogicalWidth;
-                IntRect pageRect(pageLogicalLeft, pageLogicalTop, pageLogicalWidth, pageLogicalHeight);
-                if (!isHorizontal)
-                    pageRect = pageRect.transposedRect();
-                m_pageContentRects.append(pageRect);
-            }
-        } else {
-            int pageLogicalLeft = inlineDirectionEnd > inlineDirectionStart ? inlineDirectionStart : inlineDirectionStart - pageLogicalWidth;
-            IntRect pageRect(pageLogicalLeft, pageLogicalTop, pageLogicalWidth, pageLogicalHeight);
-            if (!isHorizontal)
-                pageRect = pageRect.transposedRect();
-            m_pageContentRects.append(pageRect);
+        RenderTableRow* rowRenderer = section->rowRendererAt(row);
+        Node* rowNode = rowRenderer ? rowRenderer->node() : 0;
+        if (!offsetInPage && rowNode && !rowNode->isEqualNode(head)) {
+            HeaderInsertion insertion;
+            insertion.tableBody = section->node();
+            insertion.row = rowNode;
+            insertion.head = head;
+            insertions.append(insertion);
+            position += headLogicalHeight;
         }
-    }
-}
 
-bool LibreImpuestoPrintContext::insertHeader( RefPtr<HTMLTableRowElement>& head, RefPtr<Node>& tableBody, unsigned pageHeight)
-{
-  bool result = false;
-  LayoutPoint coord;
-  RefPtr<Node> row;
-  ExceptionCode ec = 0;
-  RenderObject* renderer;
-  RenderTableRow* renderTableRow;
-  PassRefPtr<NodeList> listRow =  tableBody->childNodes();	  
-
-  for(unsigned iterRow=0; iterRow < listRow->length(); iterRow++) {
-    row = listRow->item(iterRow);
-    renderer = row->renderer();
-    if ( renderer && renderer->isTableRow() ) {
-      renderTableRow = toRenderTableRow(renderer);
-      coord = roundedLayoutPoint(renderTableRow->localToAbsolute());
-      if ( (coord.y() % pageHeight) == 0 && 
-	   !row->isEqualNode(head->toNode()) ) {
-	tableBody->insertBefore(head->cloneElementWithChildren(), row.get(), ec);
-	result = true;
-	break;
-      }
+        position += rowHeight;
     }
-  }
-  return result;
+
+    documentShift += position - sectionTop - section->logicalHeight();
 }
 
 void LibreImpuestoPrintContext::fillRows( float width, float height, float headerHeight, float footerHeight )
@@ -295,46 +343,75 @@ void LibreImpuestoPrintContext::fillRows( float width, float height, float heade
 
     Document* document = m_contentFrame->document();
     HTMLElement* body = document->body();
+    if (!body)
+        return;
+
+    int pageHeight = view->pageLogicalHeight();
+    if (!pageHeight)
+        return;
+
     RefPtr<HTMLTableRowElement> head;
     RefPtr<Node> tableHead;
     RefPtr<Node> tableBody;
-    RefPtr<Node> table;    
+    RefPtr<Node> table;
+    Vector<HeaderInsertion> insertions;
+    int documentShift = 0;
 
     // Iterate all tables
-    PassRefPtr<NodeList> listTable = body->getElementsByTagName("table");
-    unsigned pageHeight = toRenderView(document->renderer())->pageLogicalHeight();
-    for (unsigned iterTable=0; iterTable < listTable->length(); iterTable++) {
-      table = listTable->item(iterTable);
-
-      // iterate all head sections
-      PassRefPtr<NodeList> listHead = table->getElementsByTagName("thead");
-      for(unsigned iterHead=0; iterHead < listHead->length(); iterHead++ ) {
-	tableHead = listHead->item(iterHead);
-
-	// iterate all rows
-	PassRefPtr<NodeList> listRow = tableHead->childNodes();
-	for(unsigned iterRow=0; iterRow < listRow->length(); iterRow++ ) {
-	  if (listRow->item(iterRow)->hasTagName(HTMLNames::trTag)) {
-	    head = static_cast<HTMLTableRowElement*>(listRow->item(iterRow));
-	    break;
-	  }
-	}
-      }
-
-      // if no header found .. continue.
-      if ( !head ) continue;
-
-      // iterate all body section
-      PassRefPtr<NodeList> listBody = table->getElementsByTagName("tbody");
-      for(unsigned iterBody=0; iterBody < listBody->length(); iterBody++) {
-	tableBody = listBody->item(iterBody);
-
-	while ( insertHeader( head, tableBody, pageHeight ))
-	  m_contentFrame->setPrinting(true, minLayoutSize, originalPageSize, printingMaximumShrinkFactor / printingMinimumShrinkFactor, AdjustViewSize);
-      }
-
-      head = 0;
+    RefPtr<NodeList> listTable = body->getElementsByTagName("table");
+    for (unsigned iterTable = 0; iterTable < listTable->length(); iterTable++) {
+        table = listTable->item(iterTable);
+
+        // iterate all head sections
+        RefPtr<NodeList> listHead = table->getElementsByTagName("thead");
+        for (unsigned iterHead = 0; iterHead < listHead->length(); iterHead++) {
+            tableHead = listHead->item(iterHead);
+
+            // iterate all rows
+            RefPtr<NodeList> listRow = tableHead->childNodes();
+            for (unsigned iterRow = 0; iterRow < listRow->length(); iterRow++) {
+                if (listRow->item(iterRow)->hasTagName(HTMLNames::trTag)) {
+                    head = static_cast<HTMLTableRowElement*>(listRow->item(iterRow));
+                    break;
+                }
+            }
+        }
+
+        // if no header found .. continue.
+        if (!head || !head->renderer() || !head->renderer()->isTableRow()) {
+            head = 0;
+            continue;
+        }
+
+        RenderTableRow* headRenderer = toRenderTableRow(head->renderer());
+        RenderTableSection* headSection = headRenderer->section();
+        unsigned headIndex = headSection->rowIndexForRenderer(headRenderer);
+        int headLogicalHeight = headSection->rowPositions()[headIndex + 1] - headSection->rowPositions()[headIndex];
+
+        // iterate all body section
+        RefPtr<NodeList> listBody = table->getElementsByTagName("tbody");
+        for (unsigned iterBody = 0; iterBody < listBody->length(); iterBody++) {
+            tableBody = listBody->item(iterBody);
+
+            RenderObject* renderer = tableBody->renderer();
+            if (!renderer || !renderer->isTableSection())
+                continue;
+
+            collectHeaderInsertions(toRenderTableSection(renderer), head.get(), headLogicalHeight, pageHeight, documentShift, insertions);
+        }
+
+        head = 0;
     }
+
+    if (insertions.isEmpty())
+        return;
+
+    ExceptionCode ec = 0;
+    for (size_t i = 0; i < insertions.size(); ++i)
+        insertions[i].tableBody->insertBefore(insertions[i].head->cloneElementWithChildren(), insertions[i].row.get(), ec);
+
+    // A single relayout picks up every inserted header row.
+    m_contentFrame->setPrinting(true, minLayoutSize, originalPageSize, printingMaximumShrinkFactor / printingMinimumShrinkFactor, AdjustViewSize);
 }
 
 void LibreImpuestoPrintContext::computeHeaderFooterHeight( float pageHeight,  float &headerHeight, float &footerHeight )
@@ -349,6 +426,7 @@ void LibreImpuestoPrintContext::computeHeaderFooterHeight( float pageHeight,  fl
     headerHeight = 0;
 
   m_headerHeight = headerHeight;
+  invalidateHeaderFooterCache();
 
   view = toRenderView(m_footerFrame->document()->renderer());
   const IntRect& footerRect = view->documentRect();
@@ -365,6 +443,7 @@ void LibreImpuestoPrintContext::begin(float width, float height)
 {
     // This function can be called multiple times to adjust printing parameters without going back to screen mode.
     m_isPrinting = true;
+    invalidateHeaderFooterCache();
 
     FloatSize originalPageSize = FloatSize(width, height);
     FloatSize minLayoutSize = m_contentFrame->resizePageRectsKeepingRatio(originalPageSize, 
@@ -392,6 +471,7 @@ void LibreImpuestoPrintContext::beginPage(float width, float height, float heade
 
     // This function can be called multiple times to adjust printing parameters without going back to screen mode.
     m_isPrinting = true;
+    invalidateHeaderFooterCache();
 
     view = toRenderView(m_contentFrame->document()->renderer());
     const IntRect& documentRect = view->documentRect();
@@ -441,7 +521,7 @@ float LibreImpuestoPrintContext::computeAutomaticScaleFactor(const FloatSize& av
 void LibreImpuestoPrintContext::spoolPage(GraphicsContext& ctx, int pageNumber, float width)
 {
     // FIXME: Not correct for vertical text.
-  IntRect pageContentRect = m_pageContentRects[pageNumber];
+  IntRect pageContentRect = pageRect(pageNumber);
   float scale = width / pageContentRect.width();
 
   const IntRect& headerRect = IntRect(0, 0, pageContentRect.width(), m_headerHeight);
@@ -459,19 +539,151 @@ void LibreImpuestoPrintContext::spoolPage(GraphicsContext& ctx, int pageNumber,
   ctx.scale(FloatSize(scale, scale));
   ctx.translate(0,0);
   ctx.clip(headerRect);
+#if USE(CAIRO)
+  paintRecordedFrame(ctx, m_headerFrame, headerRect, m_headerRecording);
+#else
   m_headerFrame->view()->paintContents(&ctx, headerRect);
+#endif
   ctx.restore();
 
   ctx.save();
   ctx.scale(FloatSize(scale, scale));
   ctx.translate(0, headerRect.height() + pageContentRect.height());
   ctx.clip(footerRect);
+#if USE(CAIRO)
+  paintRecordedFrame(ctx, m_footerFrame, footerRect, m_footerRecording);
+#else
   m_footerFrame->view()->paintContents(&ctx, footerRect);
+#endif
   ctx.restore();
 
 
 }
 
+#if USE(CAIRO)
+// The header and footer are the same on every page, so they are painted once into a
+// recording surface and replayed, which keeps the output vectorial for PDF targets.
+// The recordings are dropped whenever the frames are laid out again.
+void LibreImpuestoPrintContext::paintRecordedFrame(GraphicsContext& ctx, Frame* frame, const IntRect& rect, RefPtr<cairo_surface_t>& recording)
+{
+    if (rect.isEmpty())
+        return;
+
+    // Page snapshots are rasterized on worker threads, so they must not share a recording.
+    if (m_isSnapshottingPages) {
+        frame->view()->paintContents(&ctx, rect);
+        return;
+    }
+
+    if (!recording) {
+        cairo_rectangle_t extents = { 0, 0, static_cast<double>(rect.width()), static_cast<double>(rect.height()) };
+        recording = adoptRef(cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents));
+
+        RefPtr<cairo_t> recordingContext = adoptRef(cairo_create(recording.get()));
+        PlatformContextCairo platformContext(recordingContext.get());
+        GraphicsContext recordingGraphicsContext(&platformContext);
+        frame->view()->paintContents(&recordingGraphicsContext, rect);
+    }
+
+    cairo_t* cr = ctx.platformContext()->cr();
+    cairo_set_source_surface(cr, recording.get(), 0, 0);
+    cairo_paint(cr);
+}
+
+struct RasterizePagesParameters {
+    const Vector<RefPtr<cairo_surface_t> >* snapshots;
+    Vector<RefPtr<cairo_surface_t> >* images;
+    size_t start;
+    size_t end;
+    int width;
+    int height;
+};
+
+static void rasterizePagesWorker(RasterizePagesParameters* parameters)
+{
+    for (size_t i = parameters->start; i < parameters->end; ++i) {
+        RefPtr<cairo_surface_t> image = adoptRef(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, parameters->width, parameters->height));
+        RefPtr<cairo_t> cr = adoptRef(cairo_create(image.get()));
+
+        cairo_set_source_rgb(cr.get(), 1, 1, 1);
+        cairo_paint(cr.get());
+        cairo_set_source_surface(cr.get(), parameters->snapshots->at(i).get(), 0, 0);
+        cairo_paint(cr.get());
+
+        parameters->images->at(i) = image.release();
+    }
+}
+
+PassRefPtr<cairo_surface_t> LibreImpuestoPrintContext::snapshotPage(size_t pageNumber, float width, float height)
+{
+    cairo_rectangle_t extents = { 0, 0, width, height };
+    RefPtr<cairo_surface_t> snapshot = adoptRef(cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents));
+    RefPtr<cairo_t> cr = adoptRef(cairo_create(snapshot.get()));
+
+    PlatformContextCairo platformContext(cr.get());
+    GraphicsContext graphicsContext(&platformContext);
+
+    m_isSnapshottingPages = true;
+    spoolPage(graphicsContext, pageNumber, width);
+    m_isSnapshottingPages = false;
+
+    return snapshot.release();
+}
+
+// Painting has to happen on the main thread, but replaying the recorded pages into
+// pixels does not touch WebCore, so that part is spread over WTF::ParallelJobs.
+void LibreImpuestoPrintContext::rasterizePages(size_t firstPage, size_t count, float width, float height, Vector<RefPtr<cairo_surface_t> >& images)
+{
+    images.clear();
+    if (!count)
+        return;
+
+    Vector<RefPtr<cairo_surface_t> > snapshots(count);
+    for (size_t i = 0; i < count; ++i)
+        snapshots[i] = snapshotPage(firstPage + i, width, height);
+
+    images.resize(count);
+
+    RasterizePagesParameters parameters;
+    parameters.snapshots = &snapshots;
+    parameters.images = &images;
+    parameters.start = 0;
+    parameters.end = count;
+    parameters.width = ceilf(width);
+    parameters.height = ceilf(height);
+
+    if (count > 1) {
+        WTF::ParallelJobs<RasterizePagesParameters> parallelJobs(&rasterizePagesWorker, count);
+
+        size_t jobs = parallelJobs.numberOfJobs();
+        if (jobs > 1) {
+            size_t start = 0;
+            for (size_t i = 0; i < jobs; ++i) {
+                RasterizePagesParameters& jobParameters = parallelJobs.parameter(i);
+                jobParameters = parameters;
+                jobParameters.start = start;
+                jobParameters.end = i == jobs - 1 ? count : start + count / jobs;
+                start = jobParameters.end;
+            }
+
+            parallelJobs.execute();
+            return;
+        }
+    }
+
+    // Fallback to single threaded mode if there is no room for a new thread.
+    rasterizePagesWorker(&parameters);
+}
+#endif
+
+void LibreImpuestoPrintContext::invalidateHeaderFooterCache()
+{
+#if USE(CAIRO)
+    m_headerRecording = 0;
+    m_footerRecording = 0;
+#endif
+}
+
 void LibreImpuestoPrintContext::spoolRect(GraphicsContext& ctx, const IntRect& rect)
 {
     // FIXME: Not correct for vertical text.
@@ -486,6 +698,7 @@ void LibreImpuestoPrintContext::end()
 {
     ASSERT(m_isPrinting);
     m_isPrinting = false;
+    invalidateHeaderFooterCache();
     m_contentFrame->setPrinting(false, FloatSize(), FloatSize(), 0, AdjustViewSize);
 }
 
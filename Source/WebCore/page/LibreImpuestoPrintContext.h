@@ -27,6 +27,10 @@
 #include <wtf/Vector.h>
 #include "HTMLTableRowElement.h"
 
+#if USE(CAIRO)
+#include "RefPtrCairo.h"
+#endif
+
 namespace WebCore {
 
 class Element;
@@ -35,6 +39,7 @@ class FloatRect;
 class FloatSize;
 class GraphicsContext;
 class IntRect;
+class RenderTableSection;
 
 class LibreImpuestoPrintContext {
 public:
@@ -54,9 +59,18 @@ public:
     // Deprecated. Page size computation is already in this class, clients shouldn't be copying it.
     void computePageRectsWithPageSize(const FloatSize& pageSizeInPixels, bool allowHorizontalTiling);
 
+    // Streaming alternative to computePageRects(): only the page geometry is computed up front,
+    // the page rects are appended in chunks by computeNextPageRects(), which returns true once
+    // every page is known. Rects of pages already spooled can be dropped with discardPageRectsBefore().
+    void beginStreaming(const FloatRect& printRect, float headerHeight, float footerHeight, float userScaleFactor, float& outPageHeight, bool allowHorizontalTiling = false);
+    bool computeNextPageRects(size_t maxPageCount);
+    void discardPageRectsBefore(size_t pageNumber);
+    bool isStreaming() const { return m_isStreaming; }
+
     // These are only valid after page rects are computed.
-    size_t pageCount() const { return m_pageContentRects.size(); }
-    const IntRect& pageRect(size_t pageNumber) const { return m_pageContentRects[pageNumber]; }
+    size_t pageCount() const { return m_firstPageNumber + m_pageContentRects.size(); }
+    IntRect pageRect(size_t pageNumber) const;
+    // In streaming mode this only holds the rects from the first page not yet discarded.
     const Vector<IntRect>& pageRects() const { return m_pageContentRects; }
 
     float computeAutomaticScaleFactor(const FloatSize& availablePaperSize);
@@ -71,6 +85,16 @@ public:
 
     void spoolRect(GraphicsContext& ctx, const IntRect&);
 
+    // spoolPage() paints the header and footer once and replays them on every page.
+    // Call this if their content changes between pages.
+    void invalidateHeaderFooterCache();
+
+#if USE(CAIRO)
+    // Rasterizes |count| pages starting at |firstPage| into image surfaces of |width| x |height| pixels.
+    // Each page is recorded on the calling thread and the recordings are rasterized in parallel.
+    void rasterizePages(size_t firstPage, size_t count, float width, float height, Vector<RefPtr<cairo_surface_t> >& images);
+#endif
+
     // Return to screen mode.
     void end();
 
@@ -97,9 +121,59 @@ protected:
     LayoutUnit m_footerHeight;
 
 private:
+    // Everything needed to compute the rect of any page without keeping them all around.
+    struct PageGeometry {
+        PageGeometry()
+            : pageLogicalWidth(0), pageLogicalHeight(0)
+            , inlineDirectionStart(0), inlineDirectionEnd(0)
+            , blockDirectionStart(0), blockDirectionEnd(0)
+            , blockPageCount(0), inlinePageCount(0)
+            , isHorizontal(true), allowInlineDirectionTiling(false)
+        {
+        }
+
+        size_t pageCount() const { return blockPageCount * inlinePageCount; }
+
+        int pageLogicalWidth;
+        int pageLogicalHeight;
+        int inlineDirectionStart;
+        int inlineDirectionEnd;
+        int blockDirectionStart;
+        int blockDirectionEnd;
+        unsigned blockPageCount;
+        unsigned inlinePageCount;
+        bool isHorizontal;
+        bool allowInlineDirectionTiling;
+    };
+
+    bool computePageSize(const FloatRect& printRect, float headerHeight, float footerHeight, float userScaleFactor, float& outPageHeight, FloatSize& outPageSize);
+    static bool computePageGeometry(Frame*, const FloatSize& pageSizeInPixels, bool allowInlineDirectionTiling, PageGeometry&);
+    static IntRect pageRectForGeometry(const PageGeometry&, size_t index);
+#if USE(CAIRO)
+    void paintRecordedFrame(GraphicsContext&, Frame*, const IntRect&, RefPtr<cairo_surface_t>& recording);
+    PassRefPtr<cairo_surface_t> snapshotPage(size_t pageNumber, float width, float height);
+#endif
     void computePageRectsWithPageSizeInternal(const FloatSize& pageSizeInPixels, bool allowHorizontalTiling);
     void computeHeaderPageRectsWithPageSizeInternal(const FloatSize& pageSizeInPixels, bool allowHorizontalTiling);
-    bool insertHeader( RefPtr<HTMLTableRowElement>&, RefPtr<Node>&, unsigned);
+
+    // A cloned <thead> row to be inserted before |row| of |tableBody|.
+    struct HeaderInsertion {
+        RefPtr<Node> tableBody;
+        RefPtr<Node> row;
+        RefPtr<HTMLTableRowElement> head;
+    };
+    void collectHeaderInsertions(RenderTableSection*, HTMLTableRowElement* head, int headLogicalHeight, int pageHeight, int& documentShift, Vector<HeaderInsertion>&);
+
+    PageGeometry m_contentGeometry;
+    // Number of leading page rects dropped by discardPageRectsBefore().
+    size_t m_firstPageNumber;
+    bool m_isStreaming;
+
+#if USE(CAIRO)
+    RefPtr<cairo_surface_t> m_headerRecording;
+    RefPtr<cairo_surface_t> m_footerRecording;
+    bool m_isSnapshottingPages;
+#endif
 
     // Used to prevent misuses of begin() and end() (e.g., call end without begin).
     bool m_isPrinting;
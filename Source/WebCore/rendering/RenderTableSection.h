@@ -138,6 +138,10 @@ public:
 
     unsigned rowIndexForRenderer(const RenderTableRow*) const;
 
+    // Unpaginated row positions; layoutPaginatedRows() only moves the row and cell renderers.
+    const Vector<int>& rowPositions() const { return m_rowPos; }
+    RenderTableRow* rowRendererAt(unsigned row) const { return m_grid[row].rowRenderer; }
+
     void removeCachedCollapsedBorders(const RenderTableCell*);
     void setCachedCollapsedBorder(const RenderTableCell*, CollapsedBorderSide, CollapsedBorderValue);
     CollapsedBorderValue& cachedCollapsedBorder(const RenderTableCell*, CollapsedBorderSide);
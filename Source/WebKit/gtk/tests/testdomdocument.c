@@ -31,6 +31,17 @@
 #define HTML_DOCUMENT_ELEMENTS_CLASS "<html><body><div class=\"test\"></div><div class=\"strange\"></div><div class=\"test\"></div></body></html>"
 #define HTML_DOCUMENT_ELEMENTS_ID "<html><body><div id=\"testok\"></div><div id=\"testbad\">first</div><div id=\"testbad\">second</div></body></html>"
 #define HTML_DOCUMENT_LINKS "<html><head><title>Title</title></head><body><a href=\"about:blank\">blank</a><a href=\"http://www.google.com\">google</a><a href=\"http://www.webkit.org\">webkit</a></body></html>"
+#define HTML_DOCUMENT_STYLE_INVALIDATION "<html><head><style>" \
+    ".x .y { color: rgb(0, 128, 0); }" \
+    "#x .y { font-style: italic; }" \
+    ".x + .y { background-color: rgb(0, 0, 255); }" \
+    "span:not(.x) { border-top-style: solid; }" \
+    "[class~=x] { outline-style: dotted; }" \
+    "</style></head><body>" \
+    "<div id='outer'><span id='inner' class='y'></span></div>" \
+    "<span id='previous'></span><span id='next' class='y'></span>" \
+    "<span id='plain' class='w'></span>" \
+    "</body></html>"
 #define HTML_DOCUMENT_IFRAME "<html><head><title>IFrame</title></head><body><iframe id='iframe'></iframe><div id='test'></div></body></html>"
 
 typedef struct {
@@ -187,6 +198,145 @@ static void test_dom_document_get_links(DomDocumentFixture* fixture, gconstpoint
     g_object_unref(collection);
 }
 
+static void check_selector_matching(WebKitDOMDocument* document, const gchar* selector, const gchar* property, const gchar* matchingValue)
+{
+    WebKitDOMDOMWindow* domWindow = webkit_dom_document_get_default_view(document);
+    g_assert(domWindow);
+    WebKitDOMNodeList* list = webkit_dom_document_query_selector_all(document, "span", NULL);
+    g_assert(list);
+    gulong length = webkit_dom_node_list_get_length(list);
+    g_assert_cmpint(length, >, 0);
+
+    guint matches = 0;
+    guint i;
+
+    for (i = 0; i < length; i++) {
+        WebKitDOMElement* element = (WebKitDOMElement*)webkit_dom_node_list_item(list, i);
+        g_assert(element);
+        /* matchesSelector() always goes through SelectorChecker, while style
+         * resolution switches to compiled selectors once a rule is hot. */
+        gboolean elementMatches = webkit_dom_element_webkit_matches_selector(element, selector, NULL);
+        WebKitDOMCSSStyleDeclaration* style = webkit_dom_dom_window_get_computed_style(domWindow, element, NULL);
+        g_assert(style);
+        gchar* value = webkit_dom_css_style_declaration_get_property_value(style, property);
+        g_assert_cmpint(elementMatches, ==, !g_strcmp0(value, matchingValue));
+        if (elementMatches)
+            matches++;
+        g_free(value);
+        g_object_unref(style);
+    }
+
+    g_assert_cmpuint(matches, >, 0);
+    g_assert_cmpuint(matches, <, length);
+    g_object_unref(list);
+}
+
+static void test_dom_document_selector_matching(DomDocumentFixture* fixture, gconstpointer data)
+{
+    g_assert(fixture);
+    WebKitWebView* view = (WebKitWebView*)fixture->webView;
+    g_assert(view);
+
+    /* Style rules are compiled after they have been checked a hundred times,
+     * so repeat the cases well past that. Fast checkable rules are never
+     * compiled, so both rules use a simple selector the fast path rejects. */
+    static const gchar* matchingCases =
+        /* The closest .b ancestor is not a child of .a, but a further one is. */
+        "<div class='a'><div class='b'><div class='b'><p><span title='x1'></span></p></div></div></div>"
+        "<div class='b'><div class='a'><span></span></div></div>";
+    GString* html = g_string_new("<html><head><style>"
+                                 ".a > .b [title^=x] { color: rgb(0, 128, 0); }"
+                                 "span:not([title]):not(.d) { background-color: rgb(0, 0, 255); }"
+                                 "</style></head><body>");
+    guint i;
+    for (i = 0; i < 100; i++) {
+        g_string_append(html, matchingCases);
+        g_string_append(html, "<div class='a'><div><div class='b'><span title='x2'></span></div></div></div>");
+        g_string_append(html, "<div class='a'><div class='b'><span class='d' title='y'></span></div></div>");
+    }
+    /* End with matches so the last checks run through the compiled code. */
+    g_string_append(html, matchingCases);
+    g_string_append(html, "</body></html>");
+
+    webkit_web_view_load_string(view, html->str, NULL, NULL, NULL);
+    g_idle_add((GSourceFunc)finish_loading, fixture);
+    g_main_loop_run(fixture->loop);
+    g_string_free(html, TRUE);
+
+    WebKitDOMDocument* document = webkit_web_view_get_dom_document(view);
+    g_assert(document);
+    check_selector_matching(document, ".a > .b [title^=x]", "color", "rgb(0, 128, 0)");
+    check_selector_matching(document, "span:not([title]):not(.d)", "background-color", "rgb(0, 0, 255)");
+
+    WebKitDOMNodeList* list = webkit_dom_document_query_selector_all(document, "span", NULL);
+    g_assert(list);
+    gulong length = webkit_dom_node_list_get_length(list);
+    WebKitDOMElement* element = (WebKitDOMElement*)webkit_dom_node_list_item(list, length - 2);
+    g_assert(webkit_dom_element_webkit_matches_selector(element, ".a > .b [title^=x]", NULL));
+    element = (WebKitDOMElement*)webkit_dom_node_list_item(list, length - 1);
+    g_assert(webkit_dom_element_webkit_matches_selector(element, "span:not([title]):not(.d)", NULL));
+    g_object_unref(list);
+}
+
+static void check_computed_style(WebKitDOMDocument* document, const gchar* id, const gchar* property, const gchar* expectedValue)
+{
+    WebKitDOMDOMWindow* domWindow = webkit_dom_document_get_default_view(document);
+    g_assert(domWindow);
+    WebKitDOMElement* element = webkit_dom_document_get_element_by_id(document, id);
+    g_assert(element);
+    WebKitDOMCSSStyleDeclaration* style = webkit_dom_dom_window_get_computed_style(domWindow, element, NULL);
+    g_assert(style);
+    gchar* value = webkit_dom_css_style_declaration_get_property_value(style, property);
+    g_assert_cmpstr(value, ==, expectedValue);
+    g_free(value);
+    g_object_unref(style);
+}
+
+static void set_attribute_by_id(WebKitDOMDocument* document, const gchar* id, const gchar* name, const gchar* value)
+{
+    WebKitDOMElement* element = webkit_dom_document_get_element_by_id(document, id);
+    g_assert(element);
+    webkit_dom_element_set_attribute(element, name, value, NULL);
+}
+
+static void test_dom_document_style_invalidation(DomDocumentFixture* fixture, gconstpointer data)
+{
+    g_assert(fixture);
+    WebKitWebView* view = (WebKitWebView*)fixture->webView;
+    g_assert(view);
+    WebKitDOMDocument* document = webkit_web_view_get_dom_document(view);
+    g_assert(document);
+
+    /* Class and id changes only restyle the elements the rules using them
+     * can affect, so check every kind of rule picks up both directions. */
+    check_computed_style(document, "inner", "color", "rgb(0, 0, 0)");
+    set_attribute_by_id(document, "outer", "class", "x");
+    check_computed_style(document, "inner", "color", "rgb(0, 128, 0)");
+    set_attribute_by_id(document, "outer", "class", "");
+    check_computed_style(document, "inner", "color", "rgb(0, 0, 0)");
+
+    check_computed_style(document, "inner", "font-style", "normal");
+    set_attribute_by_id(document, "outer", "id", "x");
+    check_computed_style(document, "inner", "font-style", "italic");
+    set_attribute_by_id(document, "x", "id", "outer");
+    check_computed_style(document, "inner", "font-style", "normal");
+
+    check_computed_style(document, "next", "background-color", "rgba(0, 0, 0, 0)");
+    set_attribute_by_id(document, "previous", "class", "x");
+    check_computed_style(document, "next", "background-color", "rgb(0, 0, 255)");
+    set_attribute_by_id(document, "previous", "class", "");
+    check_computed_style(document, "next", "background-color", "rgba(0, 0, 0, 0)");
+
+    check_computed_style(document, "plain", "border-top-style", "solid");
+    check_computed_style(document, "plain", "outline-style", "none");
+    set_attribute_by_id(document, "plain", "class", "w x");
+    check_computed_style(document, "plain", "border-top-style", "none");
+    check_computed_style(document, "plain", "outline-style", "dotted");
+    set_attribute_by_id(document, "plain", "class", "w");
+    check_computed_style(document, "plain", "border-top-style", "solid");
+    check_computed_style(document, "plain", "outline-style", "none");
+}
+
 static void weak_notify(gpointer data, GObject* zombie)
 {
     guint* count = (guint*)data;
@@ -353,6 +503,18 @@ int main(int argc, char** argv)
                test_dom_document_get_links,
                dom_document_fixture_teardown);
 
+    g_test_add("/webkit/domdocument/test_selector_matching",
+               DomDocumentFixture, NULL,
+               dom_document_fixture_setup,
+               test_dom_document_selector_matching,
+               dom_document_fixture_teardown);
+
+    g_test_add("/webkit/domdocument/test_style_invalidation",
+               DomDocumentFixture, HTML_DOCUMENT_STYLE_INVALIDATION,
+               dom_document_fixture_setup,
+               test_dom_document_style_invalidation,
+               dom_document_fixture_teardown);
+
     g_test_add("/webkit/domdocument/test_garbage_collection",
                DomDocumentFixture, HTML_DOCUMENT_LINKS,
                dom_document_fixture_setup,
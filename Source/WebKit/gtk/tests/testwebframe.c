@@ -18,6 +18,7 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <cairo-pdf.h>
 #include <errno.h>
 #include <unistd.h>
 #include <glib.h>
@@ -199,6 +200,93 @@ cleanup:
     g_free(temporaryFilename);
 }
 
+static void load_status_changed_cb(WebKitWebView* webView, GParamSpec* spec, GMainLoop* loop)
+{
+    WebKitLoadStatus status = webkit_web_view_get_load_status(webView);
+    if (status == WEBKIT_LOAD_FINISHED || status == WEBKIT_LOAD_FAILED)
+        g_main_loop_quit(loop);
+}
+
+static WebKitWebView* create_loaded_web_view(const gchar* html)
+{
+    WebKitWebView* webView = WEBKIT_WEB_VIEW(webkit_web_view_new());
+    g_object_ref_sink(webView);
+
+    GMainLoop* loop = g_main_loop_new(NULL, TRUE);
+    g_signal_connect(webView, "notify::load-status", G_CALLBACK(load_status_changed_cb), loop);
+    webkit_web_view_load_string(webView, html, "text/html", "utf-8", "file://");
+    g_main_loop_run(loop);
+    g_signal_handlers_disconnect_by_func(webView, load_status_changed_cb, loop);
+    g_main_loop_unref(loop);
+
+    g_assert_cmpint(webkit_web_view_get_load_status(webView), ==, WEBKIT_LOAD_FINISHED);
+    return webView;
+}
+
+static goffset file_size(const gchar* filename)
+{
+    GStatBuf buffer;
+    if (g_stat(filename, &buffer) == -1)
+        return -1;
+    return buffer.st_size;
+}
+
+static void test_webkit_web_frame_libre_impuesto_printing(void)
+{
+    WebKitWebView* header = create_loaded_web_view("<html><body><p>Header</p></body></html>");
+    WebKitWebView* content = create_loaded_web_view("<html><body><h1>WebKitGTK+!</h1></body></html>");
+    WebKitWebView* footer = create_loaded_web_view("<html><body><p>Footer</p></body></html>");
+    WebKitWebFrame* headerFrame = webkit_web_view_get_main_frame(header);
+    WebKitWebFrame* contentFrame = webkit_web_view_get_main_frame(content);
+    WebKitWebFrame* footerFrame = webkit_web_view_get_main_frame(footer);
+
+    GError* error = NULL;
+    gchar* temporaryFilename = NULL;
+    gint fd = g_file_open_tmp("webkit-testwebframe-XXXXXX", &temporaryFilename, &error);
+    g_assert_no_error(error);
+    close(fd);
+
+    // Does printing to a surface produce pages?
+    cairo_surface_t* surface = cairo_pdf_surface_create(temporaryFilename, 595, 842);
+    gint pages = webkit_web_frame_libre_impuesto_print_to_surface(headerFrame, contentFrame, footerFrame, surface, 595, 842, &error);
+    g_assert_no_error(error);
+    g_assert_cmpint(pages, >, 0);
+
+    // Does printing a queue of documents append their pages to the surface?
+    const gchar* documents[] = {
+        "<html><body><p>First document</p></body></html>",
+        "<html><body><p>Second document</p></body></html>",
+        NULL
+    };
+    gint documentPages = webkit_web_frame_libre_impuesto_print_documents(headerFrame, contentFrame, footerFrame, documents, "file://", surface, 595, 842, &error);
+    g_assert_no_error(error);
+    g_assert_cmpint(documentPages, >=, 2);
+
+    cairo_surface_finish(surface);
+    g_assert_cmpint(cairo_surface_status(surface), ==, CAIRO_STATUS_SUCCESS);
+    cairo_surface_destroy(surface);
+    g_assert_cmpint(file_size(temporaryFilename), >, 0);
+
+    // Does printing to PNG write one non-empty file per page?
+    pages = webkit_web_frame_libre_impuesto_print_to_png(headerFrame, contentFrame, footerFrame, temporaryFilename, 595, 842, &error);
+    g_assert_no_error(error);
+    g_assert_cmpint(pages, >, 0);
+
+    gint i;
+    for (i = 1; i <= pages; i++) {
+        gchar* pngFilename = g_strdup_printf("%s-%d.png", temporaryFilename, i);
+        g_assert_cmpint(file_size(pngFilename), >, 0);
+        g_unlink(pngFilename);
+        g_free(pngFilename);
+    }
+
+    g_unlink(temporaryFilename);
+    g_free(temporaryFilename);
+    g_object_unref(header);
+    g_object_unref(content);
+    g_object_unref(footer);
+}
+
 static void test_webkit_web_frame_response()
 {
     WebKitWebFrame* frame = g_object_new(WEBKIT_TYPE_WEB_FRAME, NULL);
@@ -216,6 +304,7 @@ int main(int argc, char** argv)
     g_test_add_func("/webkit/webview/frame-created_signal", test_webkit_web_frame_created_signal);
     g_test_add_func("/webkit/webframe/lifetime", test_webkit_web_frame_lifetime);
     g_test_add_func("/webkit/webview/printing", test_webkit_web_frame_printing);
+    g_test_add_func("/webkit/webframe/libre_impuesto_printing", test_webkit_web_frame_libre_impuesto_printing);
     g_test_add_func("/webkit/webview/response", test_webkit_web_frame_response);
     return g_test_run ();
 }
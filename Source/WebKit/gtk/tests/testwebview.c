@@ -421,6 +421,40 @@ static void test_webkit_web_view_does_not_steal_focus()
     g_main_loop_unref(loop);
 }
 
+static void test_webkit_web_view_regexp_prefix_scan()
+{
+    loop = g_main_loop_new(NULL, TRUE);
+
+    WebKitWebView* view = WEBKIT_WEB_VIEW(webkit_web_view_new());
+    g_object_ref_sink(view);
+
+    /* Each subject is long enough for the vectorized prefix scan to run
+       over several blocks before reaching the match at index 40. The
+       \u0161 case checks that a 16-bit prefix is not matched by its low
+       byte ('a'), and the last case is case-insensitive. */
+    g_signal_connect(view, "notify::load-status", G_CALLBACK(idle_quit_loop_cb), NULL);
+    webkit_web_view_load_html_string(view,
+        "<html><body><script>"
+        "    var padding = new Array(41).join('x');"
+        "    var aPadding = new Array(41).join('a');"
+        "    var latin1 = padding + '\\u00e9a' + padding;"
+        "    var wide = padding + '\\u4e2d\\u6587' + padding;"
+        "    document.title = ["
+        "        latin1.search(/\\u00e9a/),"
+        "        latin1.search(/\\u00e9\\u00e9/),"
+        "        wide.search(/\\u4e2d\\u6587/),"
+        "        (aPadding + '\\u0161b' + aPadding).search(/\\u0161b/),"
+        "        (padding + '\\u00e9A' + padding).search(/\\u00e9a/i)"
+        "    ].join(',');"
+        "</script></body></html>", "file://");
+    g_main_loop_run(loop);
+
+    g_assert_cmpstr(webkit_web_view_get_title(view), ==, "40,-1,40,40,40");
+
+    g_object_unref(view);
+    g_main_loop_unref(loop);
+}
+
 int main(int argc, char** argv)
 {
     SoupServer* server;
@@ -450,6 +484,7 @@ int main(int argc, char** argv)
     g_test_add_func("/webkit/webview/window-features", test_webkit_web_view_window_features);
     g_test_add_func("/webkit/webview/webview-in-offscreen-window-does-not-crash", test_webkit_web_view_in_offscreen_window_does_not_crash);
     g_test_add_func("/webkit/webview/webview-does-not-steal-focus", test_webkit_web_view_does_not_steal_focus);
+    g_test_add_func("/webkit/webview/regexp-prefix-scan", test_webkit_web_view_regexp_prefix_scan);
 
     return g_test_run ();
 }
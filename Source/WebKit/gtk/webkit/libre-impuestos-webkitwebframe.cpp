@@ -42,6 +42,7 @@
 #include "JSElement.h"
 #include "PlatformContextCairo.h"
 #include "LibreImpuestoPrintContext.h"
+#include "RefPtrCairo.h"
 #include "RenderListItem.h"
 #include "RenderTreeAsText.h"
 #include "RenderView.h"
@@ -53,6 +54,7 @@
 #include "markup.h"
 #include "webkit/WebKitDOMRangePrivate.h"
 #include "webkitenumtypes.h"
+#include "webkiterror.h"
 #include "webkitglobalsprivate.h"
 #include "webkitmarshal.h"
 #include "webkitnetworkresponse.h"
@@ -66,18 +68,19 @@
 #include <JavaScriptCore/APICast.h>
 #include <atk/atk.h>
 #include <glib/gi18n-lib.h>
+#include <wtf/gobject/GOwnPtr.h>
 #include <wtf/text/CString.h>
 
 using namespace WebKit;
 using namespace WebCore;
 
+// Number of page rects computed on each emission of GtkPrintOperation::paginate.
+static const size_t libreImpuestoPaginationChunkSize = 16;
 
-static void libre_impuesto_begin_print_callback(GtkPrintOperation* op, GtkPrintContext* context, gpointer user_data)
+// Lays out the header, content and footer frames for pages of the given size and
+// starts streaming pagination of the content frame.
+static void libreImpuestoLayoutPages(LibreImpuestoPrintContext* printContext, float width, float height)
 {
-    LibreImpuestoPrintContext* printContext = reinterpret_cast<LibreImpuestoPrintContext*>(user_data);
-
-    float width = gtk_print_context_get_width(context);
-    float height = gtk_print_context_get_height(context);
     FloatRect printRect = FloatRect(0, 0, width, height);
 
     // first begin height 0
@@ -93,9 +96,30 @@ static void libre_impuesto_begin_print_callback(GtkPrintOperation* op, GtkPrintC
 
     printContext->fillRows(width, height, headerHeight, footerHeight);
 
-    printContext->computePageRects(printRect, headerHeight, footerHeight, 1.0, pageHeight);
+    // Page rects are handed out in chunks by computeNextPageRects().
+    printContext->beginStreaming(printRect, headerHeight, footerHeight, 1.0, pageHeight);
+}
+
+static void libre_impuesto_begin_print_callback(GtkPrintOperation* op, GtkPrintContext* context, gpointer user_data)
+{
+    LibreImpuestoPrintContext* printContext = reinterpret_cast<LibreImpuestoPrintContext*>(user_data);
 
-    gtk_print_operation_set_n_pages(op, printContext->pageCount());
+    float width = gtk_print_context_get_width(context);
+    float height = gtk_print_context_get_height(context);
+
+    // Page rects are handed to GTK+ in chunks from the paginate callback.
+    libreImpuestoLayoutPages(printContext, width, height);
+}
+
+static gboolean libre_impuesto_paginate_callback(GtkPrintOperation* op, GtkPrintContext*, LibreImpuestoPrintContext* printContext)
+{
+    bool done = printContext->computeNextPageRects(libreImpuestoPaginationChunkSize);
+
+    // Report the pages known so far, GTK+ needs at least one page.
+    if (done || printContext->pageCount())
+        gtk_print_operation_set_n_pages(op, std::max<size_t>(printContext->pageCount(), 1));
+
+    return done;
 }
 
 static void libre_impuesto_draw_page_callback(GtkPrintOperation*, GtkPrintContext* gtkPrintContext, gint pageNumber, LibreImpuestoPrintContext* corePrintContext)
@@ -109,6 +133,9 @@ static void libre_impuesto_draw_page_callback(GtkPrintOperation*, GtkPrintContex
     PlatformContextCairo platformContext(cr);
     GraphicsContext graphicsContext(&platformContext);
     corePrintContext->spoolPage(graphicsContext, pageNumber, pageWidth);
+
+    // Pages are usually drawn in order, drop the rects of the ones already spooled.
+    corePrintContext->discardPageRectsBefore(pageNumber);
 }
 
 static void libre_impuesto_end_print_callback(GtkPrintOperation* op, GtkPrintContext* context, gpointer user_data)
@@ -169,8 +196,239 @@ webkit_web_frame_libre_impuesto_print_full(WebKitWebFrame* header,
     LibreImpuestoPrintContext printContext(coreHeader, coreContent, coreFooter);
 
     g_signal_connect(operation, "begin-print", G_CALLBACK(libre_impuesto_begin_print_callback), &printContext);
+    g_signal_connect(operation, "paginate", G_CALLBACK(libre_impuesto_paginate_callback), &printContext);
     g_signal_connect(operation, "draw-page", G_CALLBACK(libre_impuesto_draw_page_callback), &printContext);
     g_signal_connect(operation, "end-print", G_CALLBACK(libre_impuesto_end_print_callback), &printContext);
 
     return gtk_print_operation_run(operation, action, GTK_WINDOW(topLevel), error);
 }
+
+// Lays out the frames once and appends the pages to a paginated cairo surface (PDF,
+// PostScript, SVG) as they are paginated, dropping each page rect once it has been drawn.
+// Returns the number of pages or -1.
+static gint libreImpuestoSpoolPagesToSurface(LibreImpuestoPrintContext* printContext, cairo_surface_t* surface, float width, float height, GError** error)
+{
+    libreImpuestoLayoutPages(printContext, width, height);
+
+    RefPtr<cairo_t> cr = adoptRef(cairo_create(surface));
+
+    size_t pageNumber = 0;
+    bool done = false;
+    while (!done) {
+        done = printContext->computeNextPageRects(libreImpuestoPaginationChunkSize);
+
+        for (; pageNumber < printContext->pageCount(); ++pageNumber) {
+            {
+                PlatformContextCairo platformContext(cr.get());
+                GraphicsContext graphicsContext(&platformContext);
+                printContext->spoolPage(graphicsContext, pageNumber, width);
+            }
+            cairo_show_page(cr.get());
+
+            cairo_status_t status = cairo_status(cr.get());
+            if (status != CAIRO_STATUS_SUCCESS) {
+                g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_FAILED, cairo_status_to_string(status));
+                printContext->end();
+                return -1;
+            }
+
+            printContext->discardPageRectsBefore(pageNumber + 1);
+        }
+    }
+
+    printContext->end();
+    return pageNumber;
+}
+
+// Lays out the frames once and writes every page to <prefix>-<page number>.png. Pages are
+// rasterized in parallel, one pagination chunk at a time. Returns the number of pages or -1.
+static gint libreImpuestoSpoolPagesToPNG(LibreImpuestoPrintContext* printContext, const gchar* prefix, float width, float height, GError** error)
+{
+    libreImpuestoLayoutPages(printContext, width, height);
+
+    size_t pageNumber = 0;
+    bool done = false;
+    while (!done) {
+        done = printContext->computeNextPageRects(libreImpuestoPaginationChunkSize);
+
+        Vector<RefPtr<cairo_surface_t> > images;
+        printContext->rasterizePages(pageNumber, printContext->pageCount() - pageNumber, width, height, images);
+
+        for (size_t i = 0; i < images.size(); ++i, ++pageNumber) {
+            GOwnPtr<gchar> filename(g_strdup_printf("%s-%u.png", prefix, static_cast<unsigned>(pageNumber + 1)));
+            cairo_status_t status = cairo_surface_write_to_png(images[i].get(), filename.get());
+            if (status != CAIRO_STATUS_SUCCESS) {
+                g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED, "%s: %s", filename.get(), cairo_status_to_string(status));
+                printContext->end();
+                return -1;
+            }
+        }
+
+        printContext->discardPageRectsBefore(pageNumber);
+    }
+
+    printContext->end();
+    return pageNumber;
+}
+
+static gboolean libreImpuestoCoreFrames(WebKitWebFrame* header, WebKitWebFrame* content, WebKitWebFrame* footer, Frame*& coreHeader, Frame*& coreContent, Frame*& coreFooter)
+{
+    coreHeader = core(header);
+    coreContent = core(content);
+    coreFooter = core(footer);
+    return coreHeader && coreContent && coreFooter;
+}
+
+/**
+ * webkit_web_frame_libre_impuesto_print_to_surface:
+ * @header: a #WebKitWebFrame header to be printed
+ * @content: a #WebKitWebFrame to be printed
+ * @footer: a #WebKitWebFrame footer to be printed
+ * @surface: a paginated #cairo_surface_t, such as a PDF surface
+ * @width: the width of the page, in points
+ * @height: the height of the page, in points
+ * @error: #GError for error return
+ *
+ * Prints the given #WebKitWebFrame with its header and footer straight to
+ * @surface, without a #GtkPrintOperation. Every page is finished with
+ * cairo_show_page(), so successive calls append to the same surface.
+ *
+ * Returns: the number of pages printed, or -1 on error.
+ *
+ * Since: 1.8.1
+ */
+gint
+webkit_web_frame_libre_impuesto_print_to_surface(WebKitWebFrame* header,
+                                                 WebKitWebFrame* content,
+                                                 WebKitWebFrame* footer,
+                                                 cairo_surface_t* surface,
+                                                 gdouble width,
+                                                 gdouble height,
+                                                 GError** error)
+{
+    g_return_val_if_fail(WEBKIT_IS_WEB_FRAME(header), -1);
+    g_return_val_if_fail(WEBKIT_IS_WEB_FRAME(content), -1);
+    g_return_val_if_fail(WEBKIT_IS_WEB_FRAME(footer), -1);
+    g_return_val_if_fail(surface, -1);
+    g_return_val_if_fail(width > 0 && height > 0, -1);
+
+    Frame* coreHeader;
+    Frame* coreContent;
+    Frame* coreFooter;
+    if (!libreImpuestoCoreFrames(header, content, footer, coreHeader, coreContent, coreFooter))
+        return -1;
+
+    LibreImpuestoPrintContext printContext(coreHeader, coreContent, coreFooter);
+    return libreImpuestoSpoolPagesToSurface(&printContext, surface, width, height, error);
+}
+
+/**
+ * webkit_web_frame_libre_impuesto_print_to_png:
+ * @header: a #WebKitWebFrame header to be printed
+ * @content: a #WebKitWebFrame to be printed
+ * @footer: a #WebKitWebFrame footer to be printed
+ * @prefix: the path prefix of the PNG files
+ * @width: the width of the page, in pixels
+ * @height: the height of the page, in pixels
+ * @error: #GError for error return
+ *
+ * Prints the given #WebKitWebFrame with its header and footer to one PNG
+ * file per page, named <literal>prefix-N.png</literal> with N starting at 1.
+ * Pages are rasterized on several threads.
+ *
+ * Returns: the number of pages written, or -1 on error.
+ *
+ * Since: 1.8.1
+ */
+gint
+webkit_web_frame_libre_impuesto_print_to_png(WebKitWebFrame* header,
+                                             WebKitWebFrame* content,
+                                             WebKitWebFrame* footer,
+                                             const gchar* prefix,
+                                             gdouble width,
+                                             gdouble height,
+                                             GError** error)
+{
+    g_return_val_if_fail(WEBKIT_IS_WEB_FRAME(header), -1);
+    g_return_val_if_fail(WEBKIT_IS_WEB_FRAME(content), -1);
+    g_return_val_if_fail(WEBKIT_IS_WEB_FRAME(footer), -1);
+    g_return_val_if_fail(prefix, -1);
+    g_return_val_if_fail(width > 0 && height > 0, -1);
+
+    Frame* coreHeader;
+    Frame* coreContent;
+    Frame* coreFooter;
+    if (!libreImpuestoCoreFrames(header, content, footer, coreHeader, coreContent, coreFooter))
+        return -1;
+
+    LibreImpuestoPrintContext printContext(coreHeader, coreContent, coreFooter);
+    return libreImpuestoSpoolPagesToPNG(&printContext, prefix, width, height, error);
+}
+
+static void libreImpuestoLoadStatusChanged(WebKitWebFrame* frame, GParamSpec*, gboolean* loadDone)
+{
+    WebKitLoadStatus status = webkit_web_frame_get_load_status(frame);
+    if (status == WEBKIT_LOAD_FINISHED || status == WEBKIT_LOAD_FAILED)
+        *loadDone = TRUE;
+}
+
+/**
+ * webkit_web_frame_libre_impuesto_print_documents:
+ * @header: a #WebKitWebFrame header to be printed
+ * @content: the #WebKitWebFrame each document is loaded into
+ * @footer: a #WebKitWebFrame footer to be printed
+ * @documents: a %NULL-terminated array of HTML documents
+ * @base_uri: (allow-none): the base URI of the documents
+ * @surface: a paginated #cairo_surface_t, such as a PDF surface
+ * @width: the width of the page, in points
+ * @height: the height of the page, in points
+ * @error: #GError for error return
+ *
+ * Loads every document of @documents in turn into @content and prints it
+ * with @header and @footer to @surface, as
+ * webkit_web_frame_libre_impuesto_print_to_surface() does. The same frames,
+ * and therefore the same fonts and header and footer layout, are reused
+ * for the whole queue. The default main context is iterated while each
+ * document loads.
+ *
+ * Returns: the total number of pages printed, or -1 on error.
+ *
+ * Since: 1.8.1
+ */
+gint
+webkit_web_frame_libre_impuesto_print_documents(WebKitWebFrame* header,
+                                                WebKitWebFrame* content,
+                                                WebKitWebFrame* footer,
+                                                const gchar* const* documents,
+                                                const gchar* base_uri,
+                                                cairo_surface_t* surface,
+                                                gdouble width,
+                                                gdouble height,
+                                                GError** error)
+{
+    g_return_val_if_fail(WEBKIT_IS_WEB_FRAME(content), -1);
+    g_return_val_if_fail(documents, -1);
+
+    gint totalPages = 0;
+    for (const gchar* const* document = documents; *document; ++document) {
+        gboolean loadDone = FALSE;
+        gulong handler = g_signal_connect(content, "notify::load-status", G_CALLBACK(libreImpuestoLoadStatusChanged), &loadDone);
+        webkit_web_frame_load_string(content, *document, "text/html", "UTF-8", base_uri);
+        while (!loadDone)
+            g_main_context_iteration(0, TRUE);
+        g_signal_handler_disconnect(content, handler);
+
+        if (webkit_web_frame_get_load_status(content) == WEBKIT_LOAD_FAILED) {
+            g_set_error(error, WEBKIT_NETWORK_ERROR, WEBKIT_NETWORK_ERROR_FAILED,
+                        _("Failed to load document %u of the print queue"), static_cast<unsigned>(document - documents + 1));
+            return -1;
+        }
+
+        gint pages = webkit_web_frame_libre_impuesto_print_to_surface(header, content, footer, surface, width, height, error);
+        if (pages < 0)
+            return -1;
+        totalPages += pages;
+    }
+
+    return totalPages;
+}
@@ -44,6 +44,35 @@ webkit_web_frame_libre_impuesto_print_full      (WebKitWebFrame *header,
 		                                GtkPrintOperationAction action,
                                     		GError              **error);
 
+WEBKIT_API gint
+webkit_web_frame_libre_impuesto_print_to_surface (WebKitWebFrame *header,
+						  WebKitWebFrame *content,
+						  WebKitWebFrame *footer,
+						  cairo_surface_t *surface,
+						  gdouble width,
+						  gdouble height,
+						  GError **error);
+
+WEBKIT_API gint
+webkit_web_frame_libre_impuesto_print_to_png    (WebKitWebFrame *header,
+						WebKitWebFrame *content,
+						WebKitWebFrame *footer,
+						const gchar *prefix,
+						gdouble width,
+						gdouble height,
+						GError **error);
+
+WEBKIT_API gint
+webkit_web_frame_libre_impuesto_print_documents (WebKitWebFrame *header,
+						 WebKitWebFrame *content,
+						 WebKitWebFrame *footer,
+						 const gchar * const *documents,
+						 const gchar *base_uri,
+						 cairo_surface_t *surface,
+						 gdouble width,
+						 gdouble height,
+						 GError **error);
+
 G_END_DECLS
 
 #endif
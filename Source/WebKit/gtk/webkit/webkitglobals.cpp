@@ -40,6 +40,7 @@
 #include "ResourceHandleClient.h"
 #include "ResourceHandleInternal.h"
 #include "ResourceResponse.h"
+#include "SourceProviderCacheStorage.h"
 #include "webkitapplicationcache.h"
 #include "webkitfavicondatabase.h"
 #include "webkitglobalsprivate.h"
@@ -351,6 +352,9 @@ void webkitInit()
     GOwnPtr<gchar> cacheDirectory(g_build_filename(g_get_user_cache_dir(), "webkitgtk", "applications", NULL));
     WebCore::cacheStorage().setCacheDirectory(cacheDirectory.get());
 
+    GOwnPtr<gchar> scriptCacheDirectory(g_build_filename(g_get_user_cache_dir(), "webkitgtk", "scripts", NULL));
+    WebCore::SourceProviderCacheStorage::shared().setCacheDirectory(scriptCacheDirectory.get());
+
     PageGroup::setShouldTrackVisitedLinks(true);
 
     GOwnPtr<gchar> iconDatabasePath(g_build_filename(g_get_user_data_dir(), "webkit", "icondatabase", NULL));